@@ -10,6 +10,7 @@
 #include <zephyr/drivers/i2c.h>
 #include <zephyr/drivers/clock_control/si5351.h>
 #include <zephyr/kernel.h>
+#include <zephyr/sys/barrier.h>
 #include <string.h>
 
 #include "si5351.h"
@@ -17,383 +18,2609 @@
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(clock_control_si5351, CONFIG_CLOCK_CONTROL_LOG_LEVEL);
 
-int si5351_get_status(const struct device *dev, si5351_status_t *status)
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_STATS
+#define SI5351_STATS_LATENCY_NAME(n, name) STATS_NAME(si5351_stats, name##_lat_##n)
+
+STATS_NAME_START(si5351_stats)
+STATS_NAME(si5351_stats, transactions)
+STATS_NAME(si5351_stats, bytes_written)
+STATS_NAME(si5351_stats, bytes_read)
+STATS_NAME(si5351_stats, io_errors)
+STATS_NAME(si5351_stats, pll_resets)
+LISTIFY(SI5351_STATS_LATENCY_BUCKETS, SI5351_STATS_LATENCY_NAME, (), tune_pll)
+LISTIFY(SI5351_STATS_LATENCY_BUCKETS, SI5351_STATS_LATENCY_NAME, (), set_params)
+STATS_NAME_END(si5351_stats);
+
+// Register address byte plus payload, one transaction per call
+static void si5351_stats_bus(si5351_data_t *data, uint32_t written, uint32_t read, int result)
+{
+    STATS_INC(data->stats, transactions);
+    STATS_INCN(data->stats, bytes_written, written);
+    STATS_INCN(data->stats, bytes_read, read);
+    if (result)
+    {
+        STATS_INC(data->stats, io_errors);
+    }
+}
+
+static inline uint32_t si5351_stats_start(void)
+{
+    return k_cycle_get_32();
+}
+
+static void si5351_stats_latency(uint32_t *histogram, uint32_t start)
+{
+    uint32_t latency_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+    uint32_t bucket = latency_us == 0 ? 0 : 32 - __builtin_clz(latency_us);
+
+    histogram[MIN(bucket, SI5351_STATS_LATENCY_BUCKETS - 1)]++;
+}
+
+int si5351_stats_reset(const struct device *dev)
+{
+    si5351_data_t *data = dev->data;
+
+    stats_reset(&data->stats.s_hdr);
+    return 0;
+}
+
+#define SI5351_STATS_INC(data, var) STATS_INC((data)->stats, var)
+#define SI5351_STATS_LATENCY_START(start) uint32_t start = si5351_stats_start()
+#define SI5351_STATS_LATENCY(data, name, start) si5351_stats_latency(&(data)->stats.name##_lat_0, start)
+#else
+#define si5351_stats_bus(data, written, read, result)
+#define SI5351_STATS_INC(data, var) ARG_UNUSED(data)
+#define SI5351_STATS_LATENCY_START(start)
+#define SI5351_STATS_LATENCY(data, name, start)
+#endif // CONFIG_CLOCK_CONTROL_SI5351_STATS
+
+// All bus traffic goes through these so it can be accounted for
+static int si5351_bus_read_byte(const struct device *dev, uint8_t reg, uint8_t *value)
+{
+    si5351_config_t const *cfg = dev->config;
+
+    int ret = i2c_reg_read_byte_dt(&cfg->i2c, reg, value);
+    si5351_stats_bus((si5351_data_t *)dev->data, 1, 1, ret);
+    return ret;
+}
+
+static int si5351_bus_write_byte(const struct device *dev, uint8_t reg, uint8_t value)
+{
+    si5351_config_t const *cfg = dev->config;
+
+    int ret = i2c_reg_write_byte_dt(&cfg->i2c, reg, value);
+    si5351_stats_bus((si5351_data_t *)dev->data, 2, 0, ret);
+    return ret;
+}
+
+static int si5351_bus_burst_read(const struct device *dev, uint8_t reg, uint8_t *buffer, uint32_t length)
+{
+    si5351_config_t const *cfg = dev->config;
+
+    int ret = i2c_burst_read_dt(&cfg->i2c, reg, buffer, length);
+    si5351_stats_bus((si5351_data_t *)dev->data, 1, length, ret);
+    return ret;
+}
+
+#ifndef CONFIG_CLOCK_CONTROL_SI5351_RTIO
+static int si5351_bus_burst_write(const struct device *dev, uint8_t reg, uint8_t const *buffer, uint32_t length)
 {
     si5351_config_t const *cfg = dev->config;
-    struct i2c_dt_spec const *i2c = &cfg->i2c;
+
+    int ret = i2c_burst_write_dt(&cfg->i2c, reg, buffer, length);
+    si5351_stats_bus((si5351_data_t *)dev->data, 1 + length, 0, ret);
+    return ret;
+}
+#endif
+
+// Cached parameters are updated under a seqlock, readers copy them without blocking
+// and retry if a writer was active. Writers also hold a spinlock so that a reader can
+// never preempt a half finished update and spin on it.
+static inline k_spinlock_key_t si5351_state_write_begin(si5351_data_t *data)
+{
+    k_spinlock_key_t key = k_spin_lock(&data->state_lock);
+
+    atomic_inc(&data->sequence);
+    barrier_dmem_fence_full();
+    return key;
+}
+
+static inline void si5351_state_write_end(si5351_data_t *data, k_spinlock_key_t key)
+{
+    barrier_dmem_fence_full();
+    atomic_inc(&data->sequence);
+    k_spin_unlock(&data->state_lock, key);
+}
+
+static inline atomic_val_t si5351_state_read_begin(si5351_data_t *data)
+{
+    atomic_val_t sequence;
+
+    while ((sequence = atomic_get(&data->sequence)) & 1)
+    {
+        // Only reachable on SMP, the writer is running on another CPU
+    }
+    barrier_dmem_fence_full();
+    return sequence;
+}
+
+static inline bool si5351_state_read_retry(si5351_data_t *data, atomic_val_t sequence)
+{
+    barrier_dmem_fence_full();
+    return atomic_get(&data->sequence) != sequence;
+}
+
+static void si5351_decode_status(uint8_t status_register, si5351_status_t *status)
+{
+    status->sys_init = (status_register & SI5351_STATUS_SYS_INIT) != 0;
+    status->plla_loss_of_lock = (status_register & SI5351_STATUS_LOL_A) != 0;
+    status->pllb_loss_of_lock = (status_register & SI5351_STATUS_LOL_B) != 0;
+    status->clkin_loss_of_signal = (status_register & SI5351_STATUS_LOS_CLKIN) != 0;
+    status->xtal_loss_of_signal = (status_register & SI5351_STATUS_LOS_XTAL) != 0;
+    status->revision_id = status_register & SI5351_STATUS_REVID_MASK;
+}
+
+int si5351_get_status(const struct device *dev, si5351_status_t *status)
+{
+    si5351_data_t *data = dev->data;
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_INTERRUPT
+    atomic_val_t cached = atomic_get(&data->interrupt.status);
+    if (cached & SI5351_INTERRUPT_STATUS_VALID)
+    {
+        si5351_decode_status(cached, status);
+        return 0;
+    }
+#endif
 
     uint8_t status_register;
-    if (i2c_reg_read_byte_dt(i2c, SI5351_REG_STATUS_ADR, &status_register))
+    k_mutex_lock(&data->lock, K_FOREVER);
+    int ret = si5351_bus_read_byte(dev, SI5351_REG_STATUS_ADR, &status_register);
+    k_mutex_unlock(&data->lock);
+    if (ret)
     {
         LOG_ERR("Could not read status register");
         return -EIO;
     }
 
-    status->sys_init = (status_register & 0x01) != 0;
-    status->plla_loss_of_lock = (status_register & 0x02) != 0;
-    status->pllb_loss_of_lock = (status_register & 0x04) != 0;
-    status->clkin_loss_of_signal = (status_register & 0x08) != 0;
-    status->xtal_loss_of_signal = (status_register & 0x10) != 0;
-    status->revision_id = (status_register >> 5) & 0x03;
-
+    si5351_decode_status(status_register, status);
     return 0;
 }
 
-int si5351_tune_pll(const struct device *dev, si5351_pll_mask_t pll_mask, si5351_pll_parameters_t const *parameters)
+// Poll the status register until all bits in mask are clear
+static int si5351_wait_status_clear(const struct device *dev, uint8_t mask)
+{
+    int64_t deadline = k_uptime_get() + CONFIG_CLOCK_CONTROL_SI5351_STATUS_TIMEOUT_MS;
+    uint8_t status_register;
+
+    while (true)
+    {
+        if (si5351_bus_read_byte(dev, SI5351_REG_STATUS_ADR, &status_register))
+        {
+            LOG_ERR("Could not read status register");
+            return -EIO;
+        }
+
+        if ((status_register & mask) == 0)
+        {
+            return 0;
+        }
+
+        if (k_uptime_get() >= deadline)
+        {
+            LOG_ERR("Timeout waiting for status 0x%02x, status 0x%02x", mask, status_register);
+            return -ETIMEDOUT;
+        }
+
+        k_sleep(K_USEC(CONFIG_CLOCK_CONTROL_SI5351_STATUS_POLL_INTERVAL_US));
+    }
+}
+
+static uint8_t si5351_lol_mask(si5351_pll_mask_t pll)
+{
+    return ((pll & si5351_pll_mask_a) ? SI5351_STATUS_LOL_A : 0) |
+           ((pll & si5351_pll_mask_b) ? SI5351_STATUS_LOL_B : 0);
+}
+
+static inline bool si5351_shadow_test(uint32_t const *bitmap, uint8_t reg)
+{
+    return (bitmap[reg / 32] & BIT(reg % 32)) != 0;
+}
+
+static inline void si5351_shadow_mark(uint32_t *bitmap, uint8_t reg)
+{
+    bitmap[reg / 32] |= BIT(reg % 32);
+}
+
+static inline void si5351_shadow_unmark(uint32_t *bitmap, uint8_t reg)
+{
+    bitmap[reg / 32] &= ~BIT(reg % 32);
+}
+
+// Stage a register value in the shadow, only marking it dirty if the device content differs or is unknown
+static void si5351_shadow_set(si5351_data_t *data, uint8_t reg, uint8_t value)
+{
+    si5351_shadow_t *shadow = &data->shadow;
+
+    if (si5351_shadow_test(shadow->valid, reg) && shadow->regs[reg] == value)
+    {
+        return;
+    }
+
+    shadow->regs[reg] = value;
+    si5351_shadow_mark(shadow->dirty, reg);
+}
+
+static void si5351_shadow_set_burst(si5351_data_t *data, uint8_t reg, uint8_t const *buffer, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        si5351_shadow_set(data, reg + i, buffer[i]);
+    }
+}
+
+// Find the next contiguous run of dirty registers at or after *reg and before last
+static bool si5351_shadow_next_run(si5351_shadow_t const *shadow, uint8_t *reg, uint8_t last, uint8_t *run_start, uint8_t *run_length)
+{
+    while (*reg < last && !si5351_shadow_test(shadow->dirty, *reg))
+    {
+        (*reg)++;
+    }
+    if (*reg >= last)
+    {
+        return false;
+    }
+
+    *run_start = *reg;
+    while (*reg < last && si5351_shadow_test(shadow->dirty, *reg))
+    {
+        (*reg)++;
+    }
+    *run_length = *reg - *run_start;
+
+    return true;
+}
+
+static void si5351_shadow_complete_run(si5351_shadow_t *shadow, uint8_t run_start, uint8_t run_length, bool written)
+{
+    for (uint8_t i = run_start; i < run_start + run_length; i++)
+    {
+        if (written)
+        {
+            si5351_shadow_unmark(shadow->dirty, i);
+            si5351_shadow_mark(shadow->valid, i);
+        }
+        else
+        {
+            // Device content is unknown after a failed write, keep the run dirty so it is resent
+            si5351_shadow_unmark(shadow->valid, i);
+        }
+    }
+}
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_RTIO
+// Submit up to SI5351_RTIO_MAX_RUNS dirty runs from batch.next on as one chained submission, so the
+// controller streams them back-to-back. Returns without waiting, the number of runs queued or an error.
+static int si5351_rtio_batch_submit(const struct device *dev, uint8_t last)
 {
     si5351_config_t const *cfg = dev->config;
     si5351_data_t *data = dev->data;
-    struct i2c_dt_spec const *i2c = &cfg->i2c;
+    si5351_rtio_batch_t *batch = &data->rtio_batch;
+    struct rtio *r = cfg->rtio;
 
-    uint8_t i2c_burst_buffer[SI5351_REG_PLL_X_SIZE * 2];
+    batch->num_runs = 0;
+    while (batch->num_runs < SI5351_RTIO_MAX_RUNS &&
+           si5351_shadow_next_run(&data->shadow, &batch->next, last, &batch->run_start[batch->num_runs],
+                                  &batch->run_length[batch->num_runs]))
+    {
+        batch->num_runs++;
+    }
 
-    // Set PLL multisynth settings
-    if (pll_mask & si5351_pll_mask_a)
+    for (size_t i = 0; i < batch->num_runs; i++)
     {
-        memcpy(&data->current_parameters.plla, parameters, sizeof(si5351_pll_parameters_t));
+        struct rtio_sqe *address_sqe = rtio_sqe_acquire(r);
+        struct rtio_sqe *data_sqe = rtio_sqe_acquire(r);
+        if (address_sqe == NULL || data_sqe == NULL)
+        {
+            rtio_sqe_drop_all(r);
+            batch->num_runs = 0;
+            LOG_ERR("RTIO submission queue full");
+            return -ENOMEM;
+        }
+
+        // Register address and data form one I2C transaction, runs are chained to each other
+        rtio_sqe_prep_tiny_write(address_sqe, cfg->iodev, RTIO_PRIO_NORMAL, &batch->run_start[i], 1, (void *)(uintptr_t)i);
+        address_sqe->flags |= RTIO_SQE_TRANSACTION;
+        rtio_sqe_prep_write(data_sqe, cfg->iodev, RTIO_PRIO_NORMAL, &data->shadow.regs[batch->run_start[i]],
+                            batch->run_length[i], (void *)(uintptr_t)i);
+        data_sqe->iodev_flags |= RTIO_IODEV_I2C_STOP;
+        if (i + 1 < batch->num_runs)
+        {
+            data_sqe->flags |= RTIO_SQE_CHAINED;
+        }
     }
-    if (pll_mask & si5351_pll_mask_b)
+
+    if (batch->num_runs > 0)
     {
-        memcpy(&data->current_parameters.pllb, parameters, sizeof(si5351_pll_parameters_t));
+        rtio_submit(r, 0);
     }
 
-    i2c_burst_buffer[SI5351_REG_PLL_X_P3M_OFFSET] = (data->current_parameters.plla.p3 & 0x00ff00) >> 8;
-    i2c_burst_buffer[SI5351_REG_PLL_X_P3L_OFFSET] = (data->current_parameters.plla.p3 & 0x0000ff) >> 0;
-    i2c_burst_buffer[SI5351_REG_PLL_X_P1H_OFFSET] = (data->current_parameters.plla.p1 & 0x030000) >> 16;
-    i2c_burst_buffer[SI5351_REG_PLL_X_P1M_OFFSET] = (data->current_parameters.plla.p1 & 0x00ff00) >> 8;
-    i2c_burst_buffer[SI5351_REG_PLL_X_P1L_OFFSET] = (data->current_parameters.plla.p1 & 0x0000ff) >> 0;
-    i2c_burst_buffer[SI5351_REG_PLL_X_P3HP2H_OFFSET] = (data->current_parameters.plla.p3 & 0x0f0000) >> (16 - 4) | (data->current_parameters.plla.p2 & 0x0f0000) >> 16;
-    i2c_burst_buffer[SI5351_REG_PLL_X_P2M_OFFSET] = (data->current_parameters.plla.p2 & 0x00ff00) >> 8;
-    i2c_burst_buffer[SI5351_REG_PLL_X_P2L_OFFSET] = (data->current_parameters.plla.p2 & 0x0000ff) >> 0;
+    return batch->num_runs;
+}
 
-    i2c_burst_buffer[SI5351_REG_PLL_X_SIZE + SI5351_REG_PLL_X_P3M_OFFSET] = (data->current_parameters.pllb.p3 & 0x00ff00) >> 8;
-    i2c_burst_buffer[SI5351_REG_PLL_X_SIZE + SI5351_REG_PLL_X_P3L_OFFSET] = (data->current_parameters.pllb.p3 & 0x0000ff) >> 0;
-    i2c_burst_buffer[SI5351_REG_PLL_X_SIZE + SI5351_REG_PLL_X_P1H_OFFSET] = (data->current_parameters.pllb.p1 & 0x030000) >> 16;
-    i2c_burst_buffer[SI5351_REG_PLL_X_SIZE + SI5351_REG_PLL_X_P1M_OFFSET] = (data->current_parameters.pllb.p1 & 0x00ff00) >> 8;
-    i2c_burst_buffer[SI5351_REG_PLL_X_SIZE + SI5351_REG_PLL_X_P1L_OFFSET] = (data->current_parameters.pllb.p1 & 0x0000ff) >> 0;
-    i2c_burst_buffer[SI5351_REG_PLL_X_SIZE + SI5351_REG_PLL_X_P3HP2H_OFFSET] = (data->current_parameters.pllb.p3 & 0x0f0000) >> (16 - 4) | (data->current_parameters.pllb.p2 & 0x0f0000) >> 16;
-    i2c_burst_buffer[SI5351_REG_PLL_X_SIZE + SI5351_REG_PLL_X_P2M_OFFSET] = (data->current_parameters.pllb.p2 & 0x00ff00) >> 8;
-    i2c_burst_buffer[SI5351_REG_PLL_X_SIZE + SI5351_REG_PLL_X_P2L_OFFSET] = (data->current_parameters.pllb.p2 & 0x0000ff) >> 0;
+// Wait for the submitted batch and settle the shadow of every run
+static int si5351_rtio_batch_complete(const struct device *dev)
+{
+    si5351_config_t const *cfg = dev->config;
+    si5351_data_t *data = dev->data;
+    si5351_rtio_batch_t *batch = &data->rtio_batch;
+    struct rtio *r = cfg->rtio;
 
-    if (i2c_burst_write_dt(i2c, SI5351_REG_PLL_X_ADR_BASE, i2c_burst_buffer, SI5351_REG_PLL_X_SIZE * 2))
+    // Every SQE completes, a failing step cancels the rest of the chain so the first failing run is the lowest index
+    size_t failed_run = batch->num_runs;
+    for (size_t i = 0; i < batch->num_runs * 2; i++)
     {
-        LOG_ERR("Could not write to device");
+        struct rtio_cqe *cqe = rtio_cqe_consume_block(r);
+        size_t run = (uintptr_t)cqe->userdata;
+        if (cqe->result < 0 && run < failed_run)
+        {
+            failed_run = run;
+        }
+        rtio_cqe_release(r, cqe);
+    }
+
+    for (size_t i = 0; i < batch->num_runs; i++)
+    {
+        si5351_shadow_complete_run(&data->shadow, batch->run_start[i], batch->run_length[i], i < failed_run);
+        if (i <= failed_run)
+        {
+            // Runs after a failure were cancelled and never reached the bus
+            si5351_stats_bus(data, 1 + batch->run_length[i], 0, i == failed_run ? -EIO : 0);
+        }
+    }
+
+    if (failed_run < batch->num_runs)
+    {
+        LOG_ERR("Could not write to device at register 0x%02x", batch->run_start[failed_run]);
         return -EIO;
     }
 
     return 0;
 }
 
-static int si5351_write_oeb(const struct device *dev)
+static int si5351_shadow_flush_range(const struct device *dev, uint8_t first, uint8_t last)
+{
+    si5351_data_t *data = dev->data;
+
+    data->rtio_batch.next = first;
+    while (true)
+    {
+        int ret = si5351_rtio_batch_submit(dev, last);
+        if (ret <= 0)
+        {
+            return ret;
+        }
+
+        ret = si5351_rtio_batch_complete(dev);
+        if (ret)
+        {
+            return ret;
+        }
+    }
+}
+
+// Flush all devices at once, each has its own RTIO context so devices on different buses
+// are written in parallel and devices sharing a bus are queued back-to-back by the controller
+static int si5351_shadow_flush_range_group(const struct device *const *devices, size_t num_devices, uint8_t first, uint8_t last)
+{
+    int ret = 0;
+
+    for (size_t i = 0; i < num_devices; i++)
+    {
+        si5351_data_t *data = devices[i]->data;
+        data->rtio_batch.next = first;
+    }
+
+    bool pending = true;
+    while (pending && ret == 0)
+    {
+        pending = false;
+        for (size_t i = 0; i < num_devices; i++)
+        {
+            int queued = si5351_rtio_batch_submit(devices[i], last);
+            if (queued < 0 && ret == 0)
+            {
+                ret = queued;
+            }
+            pending |= queued > 0;
+        }
+
+        for (size_t i = 0; i < num_devices; i++)
+        {
+            int completed = si5351_rtio_batch_complete(devices[i]);
+            if (completed && ret == 0)
+            {
+                ret = completed;
+            }
+        }
+    }
+
+    return ret;
+}
+#else
+// Write dirty registers in [first, last) to the device, one burst per contiguous run of dirty registers
+static int si5351_shadow_flush_range(const struct device *dev, uint8_t first, uint8_t last)
+{
+    si5351_data_t *data = dev->data;
+    si5351_shadow_t *shadow = &data->shadow;
+
+    uint8_t reg = first;
+    uint8_t run_start, run_length;
+    while (si5351_shadow_next_run(shadow, &reg, last, &run_start, &run_length))
+    {
+        if (si5351_bus_burst_write(dev, run_start, &shadow->regs[run_start], run_length))
+        {
+            si5351_shadow_complete_run(shadow, run_start, run_length, false);
+            LOG_ERR("Could not write to device");
+            return -EIO;
+        }
+
+        si5351_shadow_complete_run(shadow, run_start, run_length, true);
+    }
+
+    return 0;
+}
+
+// Blocking bus calls, devices are written one after the other
+static int si5351_shadow_flush_range_group(const struct device *const *devices, size_t num_devices, uint8_t first, uint8_t last)
+{
+    for (size_t i = 0; i < num_devices; i++)
+    {
+        int ret = si5351_shadow_flush_range(devices[i], first, last);
+        if (ret)
+        {
+            return ret;
+        }
+    }
+
+    return 0;
+}
+#endif // CONFIG_CLOCK_CONTROL_SI5351_RTIO
+
+static int si5351_shadow_flush(const struct device *dev)
+{
+    return si5351_shadow_flush_range(dev, 0, SI5351_REG_MAP_SIZE);
+}
+
+// Send staged registers, unless a transaction defers them to si5351_transaction_commit()
+static int si5351_apply_staged(const struct device *dev)
+{
+    si5351_data_t *data = dev->data;
+
+    if (data->transaction_depth > 0)
+    {
+        return 0;
+    }
+
+    return si5351_shadow_flush(dev);
+}
+
+static void si5351_encode_pll(si5351_pll_parameters_t const *parameters, uint8_t *buffer)
+{
+    buffer[SI5351_REG_PLL_X_P3M_OFFSET] = (parameters->p3 & 0x00ff00) >> 8;
+    buffer[SI5351_REG_PLL_X_P3L_OFFSET] = (parameters->p3 & 0x0000ff) >> 0;
+    buffer[SI5351_REG_PLL_X_P1H_OFFSET] = (parameters->p1 & 0x030000) >> 16;
+    buffer[SI5351_REG_PLL_X_P1M_OFFSET] = (parameters->p1 & 0x00ff00) >> 8;
+    buffer[SI5351_REG_PLL_X_P1L_OFFSET] = (parameters->p1 & 0x0000ff) >> 0;
+    buffer[SI5351_REG_PLL_X_P3HP2H_OFFSET] = (parameters->p3 & 0x0f0000) >> (16 - 4) | (parameters->p2 & 0x0f0000) >> 16;
+    buffer[SI5351_REG_PLL_X_P2M_OFFSET] = (parameters->p2 & 0x00ff00) >> 8;
+    buffer[SI5351_REG_PLL_X_P2L_OFFSET] = (parameters->p2 & 0x0000ff) >> 0;
+}
+
+static void si5351_encode_multisynth(si5351_output_parameters_t const *parameters, uint8_t *buffer)
+{
+    buffer[SI5351_REG_CLK_OUT_X_P3M_OFFSET] = (parameters->p3 & 0x00ff00) >> 8;
+    buffer[SI5351_REG_CLK_OUT_X_P3L_OFFSET] = (parameters->p3 & 0x0000ff) >> 0;
+    buffer[SI5351_REG_CLK_OUT_X_P1H_OFFSET] = parameters->r << 4 | (parameters->divide_by_four ? 0x3 : 0x0) << 2 | (parameters->p1 & 0x030000) >> 16;
+    buffer[SI5351_REG_CLK_OUT_X_P1M_OFFSET] = (parameters->p1 & 0x00ff00) >> 8;
+    buffer[SI5351_REG_CLK_OUT_X_P1L_OFFSET] = (parameters->p1 & 0x0000ff) >> 0;
+    buffer[SI5351_REG_CLK_OUT_X_P3HP2H_OFFSET] = (parameters->p3 & 0x0f0000) >> (16 - 4) | (parameters->p2 & 0x0f0000) >> 16;
+    buffer[SI5351_REG_CLK_OUT_X_P2M_OFFSET] = (parameters->p2 & 0x00ff00) >> 8;
+    buffer[SI5351_REG_CLK_OUT_X_P2L_OFFSET] = (parameters->p2 & 0x0000ff) >> 0;
+}
+
+static uint8_t si5351_encode_clk_ctrl(si5351_output_parameters_t const *parameters)
+{
+    return parameters->powered_up << 7 |
+           parameters->integer_mode << 6 |
+           parameters->multisynth_source << 5 |
+           parameters->invert << 4 |
+           parameters->clock_source << 2 |
+           parameters->drive_strength << 0;
+}
+
+static void si5351_decode_pll(uint8_t const *buffer, si5351_pll_parameters_t *parameters)
+{
+    parameters->p1 = (buffer[SI5351_REG_PLL_X_P1H_OFFSET] & 0x03) << 16 |
+                     buffer[SI5351_REG_PLL_X_P1M_OFFSET] << 8 |
+                     buffer[SI5351_REG_PLL_X_P1L_OFFSET];
+    parameters->p2 = (buffer[SI5351_REG_PLL_X_P3HP2H_OFFSET] & 0x0f) << 16 |
+                     buffer[SI5351_REG_PLL_X_P2M_OFFSET] << 8 |
+                     buffer[SI5351_REG_PLL_X_P2L_OFFSET];
+    parameters->p3 = (buffer[SI5351_REG_PLL_X_P3HP2H_OFFSET] & 0xf0) << 12 |
+                     buffer[SI5351_REG_PLL_X_P3M_OFFSET] << 8 |
+                     buffer[SI5351_REG_PLL_X_P3L_OFFSET];
+}
+
+static void si5351_decode_multisynth(uint8_t const *buffer, si5351_output_parameters_t *parameters)
+{
+    parameters->p1 = (buffer[SI5351_REG_CLK_OUT_X_P1H_OFFSET] & 0x03) << 16 |
+                     buffer[SI5351_REG_CLK_OUT_X_P1M_OFFSET] << 8 |
+                     buffer[SI5351_REG_CLK_OUT_X_P1L_OFFSET];
+    parameters->p2 = (buffer[SI5351_REG_CLK_OUT_X_P3HP2H_OFFSET] & 0x0f) << 16 |
+                     buffer[SI5351_REG_CLK_OUT_X_P2M_OFFSET] << 8 |
+                     buffer[SI5351_REG_CLK_OUT_X_P2L_OFFSET];
+    parameters->p3 = (buffer[SI5351_REG_CLK_OUT_X_P3HP2H_OFFSET] & 0xf0) << 12 |
+                     buffer[SI5351_REG_CLK_OUT_X_P3M_OFFSET] << 8 |
+                     buffer[SI5351_REG_CLK_OUT_X_P3L_OFFSET];
+    parameters->r = (buffer[SI5351_REG_CLK_OUT_X_P1H_OFFSET] >> 4) & 0x07;
+    parameters->divide_by_four = ((buffer[SI5351_REG_CLK_OUT_X_P1H_OFFSET] >> 2) & 0x03) == 0x03;
+}
+
+// Read the whole configuration span in a single burst, buffer is indexed by register address.
+// Registers without pending writes are refreshed in the shadow, so later diffs are against the device.
+static int si5351_read_registers(const struct device *dev, uint8_t *buffer)
 {
-    si5351_config_t const *cfg = dev->config;
     si5351_data_t *data = dev->data;
-    struct i2c_dt_spec const *i2c = &cfg->i2c;
+    si5351_shadow_t *shadow = &data->shadow;
+
+    if (si5351_bus_burst_read(dev, SI5351_REG_READBACK_FIRST, &buffer[SI5351_REG_READBACK_FIRST],
+                          SI5351_REG_READBACK_LAST - SI5351_REG_READBACK_FIRST + 1))
+    {
+        LOG_ERR("Could not read from device");
+        return -EIO;
+    }
+
+    for (int reg = SI5351_REG_READBACK_FIRST; reg <= SI5351_REG_READBACK_LAST; reg++)
+    {
+        if (reg == SI5351_REG_PLL_RESET_ADR || si5351_shadow_test(shadow->dirty, reg))
+        {
+            continue;
+        }
+        shadow->regs[reg] = buffer[reg];
+        si5351_shadow_mark(shadow->valid, reg);
+    }
+
+    return 0;
+}
+
+static void si5351_stage_pll(si5351_data_t *data, si5351_pll_mask_t pll_mask)
+{
+    uint8_t pll_buffer[SI5351_REG_PLL_X_SIZE];
+
+    if (pll_mask & si5351_pll_mask_a)
+    {
+        si5351_encode_pll(&data->current_parameters.plla, pll_buffer);
+        si5351_shadow_set_burst(data, SI5351_REG_PLL_X_ADR_BASE, pll_buffer, SI5351_REG_PLL_X_SIZE);
+    }
+    if (pll_mask & si5351_pll_mask_b)
+    {
+        si5351_encode_pll(&data->current_parameters.pllb, pll_buffer);
+        si5351_shadow_set_burst(data, SI5351_REG_PLL_X_ADR_BASE + SI5351_REG_PLL_X_SIZE, pll_buffer, SI5351_REG_PLL_X_SIZE);
+    }
+}
+
+static void si5351_stage_oeb(si5351_data_t *data)
+{
     si5351_output_parameters_t const *clock_parameters;
 
-    // Update OEB register
-    uint8_t oeb_register = 0x00;
-    for (int i = 0; i < 8; i++)
+    // Disable unused outputs and those the model lacks by default
+    uint8_t oeb_register = 0xff;
+    for (int i = 0; i < data->num_outputs; i++)
     {
         if (!data->outputs[i].output_present)
         {
-            // Disable unused outputs by default
-            oeb_register |= 1 << i;
             continue;
         }
         clock_parameters = data->outputs[i].current_parameters;
 
+        oeb_register &= ~BIT(i);
         oeb_register |= clock_parameters->output_enabled << i;
     }
-    if (i2c_reg_write_byte_dt(i2c, SI5351_REG_OEB_ADR, oeb_register))
-    {
-        LOG_ERR("Could not write to device");
-        return -EIO;
+    si5351_shadow_set(data, SI5351_REG_OEB_ADR, oeb_register);
+}
+
+// Stage multisynth, phase offset and control registers of a present output
+static void si5351_stage_output(si5351_data_t *data, uint8_t output_index)
+{
+    si5351_output_parameters_t const *clock_parameters = data->outputs[output_index].current_parameters;
+    uint8_t multisynth_buffer[SI5351_REG_CLK_OUT_X_SIZE];
+
+    if (output_index >= SI5351_INTEGER_OUTPUT_FIRST)
+    {
+        // Divide ratio itself instead of P1, no phase offset
+        si5351_shadow_set(data, SI5351_REG_CLK_OUT_INT_X_ADR_BASE + output_index - SI5351_INTEGER_OUTPUT_FIRST,
+                          (clock_parameters->p1 + 512) / 128);
+
+        uint8_t shift = SI5351_REG_CLK_OUT_INT_R_SHIFT(output_index);
+        uint8_t r_register = data->shadow.regs[SI5351_REG_CLK_OUT_INT_R_ADR] & ~(0x07 << shift);
+        si5351_shadow_set(data, SI5351_REG_CLK_OUT_INT_R_ADR, r_register | clock_parameters->r << shift);
+    }
+    else
+    {
+        si5351_shadow_set(data, SI5351_REG_CLK_OUT_PHASE_OFFSET_X_ADR_BASE + output_index * SI5351_REG_CLK_OUT_PHASE_OFFSET_X_SIZE,
+                          clock_parameters->phase_offset);
+
+        si5351_encode_multisynth(clock_parameters, multisynth_buffer);
+        si5351_shadow_set_burst(data, SI5351_REG_CLK_OUT_X_ADR_BASE + output_index * SI5351_REG_CLK_OUT_X_SIZE,
+                                multisynth_buffer, SI5351_REG_CLK_OUT_X_SIZE);
+    }
+
+    si5351_shadow_set(data, SI5351_REG_CLK_OUT_CTRL_ADR_BASE + output_index * SI5351_REG_CLK_OUT_CTRL_SIZE,
+                      si5351_encode_clk_ctrl(clock_parameters));
+}
+
+int si5351_tune_pll(const struct device *dev, si5351_pll_mask_t pll_mask, si5351_pll_parameters_t const *parameters)
+{
+    si5351_data_t *data = dev->data;
+    SI5351_STATS_LATENCY_START(start);
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+
+    // Set PLL multisynth settings
+    k_spinlock_key_t key = si5351_state_write_begin(data);
+    if (pll_mask & si5351_pll_mask_a)
+    {
+        memcpy(&data->current_parameters.plla, parameters, sizeof(si5351_pll_parameters_t));
+    }
+    if (pll_mask & si5351_pll_mask_b)
+    {
+        memcpy(&data->current_parameters.pllb, parameters, sizeof(si5351_pll_parameters_t));
+    }
+    si5351_state_write_end(data, key);
+
+    si5351_stage_pll(data, pll_mask);
+
+    int ret = si5351_apply_staged(dev);
+    k_mutex_unlock(&data->lock);
+
+    SI5351_STATS_LATENCY(data, tune_pll, start);
+    return ret;
+}
+
+static int si5351_write_oeb(const struct device *dev)
+{
+    si5351_data_t *data = dev->data;
+
+    // Update OEB register
+    si5351_stage_oeb(data);
+
+    return si5351_apply_staged(dev);
+}
+
+int si5351_set_output(const struct device *dev, uint8_t output_index, si5351_output_output_t state)
+{
+    si5351_data_t *data = dev->data;
+
+    if (output_index >= data->num_outputs)
+    {
+        LOG_ERR("Invalid output index: %d", output_index);
+        return -EINVAL;
+    }
+
+    if (!data->outputs[output_index].output_present)
+    {
+        LOG_ERR("Output %d is not present", output_index);
+        return -ENODEV;
+    }
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+
+    k_spinlock_key_t key = si5351_state_write_begin(data);
+    data->outputs[output_index].current_parameters->output_enabled = state;
+    si5351_state_write_end(data, key);
+
+    int ret = si5351_write_oeb(dev);
+    k_mutex_unlock(&data->lock);
+    return ret;
+}
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_INTERRUPT
+static inline bool si5351_has_interrupt(const struct device *dev)
+{
+    const si5351_config_t *cfg = dev->config;
+
+    return cfg->int_gpio.port != NULL;
+}
+
+// Interrupt mask register value, sources are only unmasked with an INTR pin to service them
+static uint8_t si5351_interrupt_mask(const struct device *dev)
+{
+    si5351_data_t *data = dev->data;
+
+    return si5351_has_interrupt(dev) ? SI5351_INTERRUPT_MASK_ALL & ~data->interrupt.armed : SI5351_INTERRUPT_MASK_ALL;
+}
+
+// Drop the cached status and have the work item read it again
+static void si5351_interrupt_refresh(const struct device *dev)
+{
+    si5351_data_t *data = dev->data;
+
+    if (si5351_has_interrupt(dev))
+    {
+        atomic_set(&data->interrupt.status, 0);
+        k_work_reschedule_for_queue(&si5351_work_q, &data->interrupt.work, K_NO_WAIT);
+    }
+}
+
+static uint8_t si5351_interrupt_events(uint8_t sticky)
+{
+    return ((sticky & SI5351_STATUS_LOS_XTAL) ? si5351_event_xtal_loss_of_signal : 0) |
+           ((sticky & SI5351_STATUS_LOS_CLKIN) ? si5351_event_clkin_loss_of_signal : 0) |
+           ((sticky & SI5351_STATUS_LOL_A) ? si5351_event_plla_loss_of_lock : 0) |
+           ((sticky & SI5351_STATUS_LOL_B) ? si5351_event_pllb_loss_of_lock : 0);
+}
+
+static void si5351_interrupt_work_handler(struct k_work *work)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    si5351_interrupt_t *interrupt = CONTAINER_OF(dwork, si5351_interrupt_t, work);
+    const struct device *dev = interrupt->dev;
+    const si5351_config_t *cfg = dev->config;
+    si5351_data_t *data = dev->data;
+    uint8_t regs[2];
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+
+    // Status and sticky register in one burst
+    if (si5351_bus_burst_read(dev, SI5351_REG_STATUS_ADR, regs, sizeof(regs)))
+    {
+        LOG_ERR("Could not read status register");
+        k_work_reschedule_for_queue(&si5351_work_q, dwork, K_MSEC(CONFIG_CLOCK_CONTROL_SI5351_INTERRUPT_RECHECK_MS));
+        goto out;
+    }
+
+    uint8_t status_register = regs[0];
+    uint8_t sticky = regs[1] & SI5351_INTERRUPT_MASK_ALL;
+
+    // Sticky bits are cleared by writing 0, anything latched after the read stays set
+    if (sticky && si5351_bus_write_byte(dev, SI5351_REG_INTERRUPT_ADR, (uint8_t)~sticky))
+    {
+        LOG_ERR("Could not write to device");
+    }
+
+    // Sources masked before this read latched the condition that was already reported
+    uint8_t events = si5351_interrupt_events(sticky & interrupt->armed);
+
+    // A persisting condition would latch again right away and hold the pin, so its source is
+    // masked and polled at a low rate until it clears
+    uint8_t active = status_register & cfg->int_sources;
+    uint8_t armed = cfg->int_sources & ~active;
+    if (armed != interrupt->armed)
+    {
+        interrupt->armed = armed;
+        si5351_shadow_set(data, SI5351_REG_INTERRUPT_MASK_ADR, si5351_interrupt_mask(dev));
+        si5351_apply_staged(dev);
+    }
+    if (active)
+    {
+        k_work_reschedule_for_queue(&si5351_work_q, dwork, K_MSEC(CONFIG_CLOCK_CONTROL_SI5351_INTERRUPT_RECHECK_MS));
+    }
+
+    // Only fresh while every serviced source is armed and would fire on a change
+    atomic_set(&interrupt->status, status_register | (active ? 0 : SI5351_INTERRUPT_STATUS_VALID));
+
+    if (events)
+    {
+        si5351_status_t status;
+        si5351_event_callback_t *callback;
+
+        si5351_decode_status(status_register, &status);
+        SYS_SLIST_FOR_EACH_CONTAINER(&interrupt->callbacks, callback, node)
+        {
+            if (callback->events & events)
+            {
+                callback->handler(dev, callback, callback->events & events, &status);
+            }
+        }
+    }
+
+    // An event latched between the read and the clear keeps the pin asserted without a new edge
+    if (gpio_pin_get_dt(&cfg->int_gpio) > 0)
+    {
+        k_work_reschedule_for_queue(&si5351_work_q, dwork, K_NO_WAIT);
+    }
+
+out:
+    k_mutex_unlock(&data->lock);
+}
+
+static void si5351_interrupt_gpio_callback(const struct device *port, struct gpio_callback *gpio_callback,
+                                           gpio_port_pins_t pins)
+{
+    si5351_interrupt_t *interrupt = CONTAINER_OF(gpio_callback, si5351_interrupt_t, gpio_callback);
+
+    atomic_set(&interrupt->status, 0);
+    k_work_reschedule_for_queue(&si5351_work_q, &interrupt->work, K_NO_WAIT);
+}
+
+static int si5351_interrupt_init(const struct device *dev)
+{
+    const si5351_config_t *cfg = dev->config;
+    si5351_data_t *data = dev->data;
+    si5351_interrupt_t *interrupt = &data->interrupt;
+
+    if (!gpio_is_ready_dt(&cfg->int_gpio))
+    {
+        LOG_ERR("Interrupt GPIO is not ready");
+        return -ENODEV;
+    }
+
+    interrupt->dev = dev;
+    interrupt->armed = cfg->int_sources;
+    atomic_set(&interrupt->status, 0);
+    sys_slist_init(&interrupt->callbacks);
+    k_work_init_delayable(&interrupt->work, si5351_interrupt_work_handler);
+
+    int ret = gpio_pin_configure_dt(&cfg->int_gpio, GPIO_INPUT);
+    if (ret)
+    {
+        return ret;
+    }
+
+    gpio_init_callback(&interrupt->gpio_callback, si5351_interrupt_gpio_callback, BIT(cfg->int_gpio.pin));
+    ret = gpio_add_callback_dt(&cfg->int_gpio, &interrupt->gpio_callback);
+    if (ret)
+    {
+        return ret;
+    }
+
+    // INTR is open drain and stays asserted while any unmasked sticky bit is set
+    return gpio_pin_interrupt_configure_dt(&cfg->int_gpio, GPIO_INT_EDGE_TO_ACTIVE);
+}
+
+int si5351_add_event_callback(const struct device *dev, si5351_event_callback_t *callback)
+{
+    si5351_data_t *data = dev->data;
+
+    if (!si5351_has_interrupt(dev))
+    {
+        return -ENOTSUP;
+    }
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    sys_slist_find_and_remove(&data->interrupt.callbacks, &callback->node);
+    sys_slist_append(&data->interrupt.callbacks, &callback->node);
+    k_mutex_unlock(&data->lock);
+
+    return 0;
+}
+
+int si5351_remove_event_callback(const struct device *dev, si5351_event_callback_t *callback)
+{
+    si5351_data_t *data = dev->data;
+
+    if (!si5351_has_interrupt(dev))
+    {
+        return -ENOTSUP;
+    }
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    bool removed = sys_slist_find_and_remove(&data->interrupt.callbacks, &callback->node);
+    k_mutex_unlock(&data->lock);
+
+    return removed ? 0 : -EINVAL;
+}
+#else
+#define si5351_interrupt_mask(dev) SI5351_INTERRUPT_MASK_ALL
+#define si5351_interrupt_refresh(dev)
+#endif // CONFIG_CLOCK_CONTROL_SI5351_INTERRUPT
+
+// Issue the reset without waiting for lock
+static int si5351_start_pll_reset(const struct device *dev, si5351_pll_mask_t pll)
+{
+    si5351_data_t *data = dev->data;
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_INTERRUPT
+    atomic_set(&data->interrupt.status, 0);
+#endif
+    SI5351_STATS_INC(data, pll_resets);
+    uint8_t pll_reset_register = 0;
+    pll_reset_register |= (pll & si5351_pll_mask_b) ? 0x80 : 0x00;
+    pll_reset_register |= (pll & si5351_pll_mask_a) ? 0x20 : 0x00;
+
+    if (si5351_bus_write_byte(dev, SI5351_REG_PLL_RESET_ADR, pll_reset_register))
+    {
+        LOG_ERR("Could not write to device");
+        return -EIO;
+    }
+
+    return 0;
+}
+
+// Wait for the PLLs to lock after a reset issued by the driver
+static int si5351_wait_pll_lock(const struct device *dev, si5351_pll_mask_t pll)
+{
+    int ret = si5351_wait_status_clear(dev, si5351_lol_mask(pll));
+    if (ret)
+    {
+        return ret;
+    }
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_INTERRUPT
+    if (si5351_has_interrupt(dev))
+    {
+        // The loss of lock latched by the reset is not an event
+        if (si5351_bus_write_byte(dev, SI5351_REG_INTERRUPT_ADR, (uint8_t)~si5351_lol_mask(pll)))
+        {
+            LOG_ERR("Could not write to device");
+            return -EIO;
+        }
+        si5351_interrupt_refresh(dev);
+    }
+#endif
+
+    return 0;
+}
+
+static int si5351_write_pll_reset(const struct device *dev, si5351_pll_mask_t pll)
+{
+    int ret = si5351_start_pll_reset(dev, pll);
+    if (ret)
+    {
+        return ret;
+    }
+
+    // Outputs are only enabled after this returns, so wait for the PLLs to lock again
+    return si5351_wait_pll_lock(dev, pll);
+}
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_INIT_IMAGE
+// Stage the build-time register image: PLL config with the output controls, PLLs up to the last
+// multisynth, phase offsets and XTAL load, each one contiguous run. Only the registers of outputs
+// the model has are taken from the image. OEB is left to the caller.
+static void si5351_stage_configuration(const struct device *dev)
+{
+    const si5351_config_t *cfg = dev->config;
+    si5351_data_t *data = dev->data;
+    uint8_t const *image = cfg->init_image;
+
+    uint8_t ctrl_end = SI5351_REG_CLK_OUT_CTRL_ADR_BASE + data->num_outputs * SI5351_REG_CLK_OUT_CTRL_SIZE;
+    si5351_shadow_set_burst(data, SI5351_REG_PLL_CFG_ADR, &image[SI5351_REG_PLL_CFG_ADR],
+                            ctrl_end - SI5351_REG_PLL_CFG_ADR);
+
+    uint8_t multisynth_end = data->num_outputs > SI5351_INTEGER_OUTPUT_FIRST
+                                 ? SI5351_REG_CLK_OUT_INT_R_ADR + 1
+                                 : SI5351_REG_CLK_OUT_X_ADR_BASE + data->num_outputs * SI5351_REG_CLK_OUT_X_SIZE;
+    si5351_shadow_set_burst(data, SI5351_REG_PLL_X_ADR_BASE, &image[SI5351_REG_PLL_X_ADR_BASE],
+                            multisynth_end - SI5351_REG_PLL_X_ADR_BASE);
+
+    uint8_t num_phase_offsets = MIN(data->num_outputs, SI5351_INTEGER_OUTPUT_FIRST);
+    si5351_shadow_set_burst(data, SI5351_REG_CLK_OUT_PHASE_OFFSET_X_ADR_BASE,
+                            &image[SI5351_REG_CLK_OUT_PHASE_OFFSET_X_ADR_BASE], num_phase_offsets);
+
+    si5351_shadow_set(data, SI5351_REG_XTAL_LOAD_ADR, image[SI5351_REG_XTAL_LOAD_ADR]);
+}
+#else
+// Stage the target configuration of PLLs and outputs
+static void si5351_stage_configuration(const struct device *dev)
+{
+    si5351_data_t *data = dev->data;
+
+    // Set PLL settings
+    uint8_t pll_cfg = data->current_parameters.clkin_div << 6 |
+                      data->current_parameters.pllb.clock_source << 3 |
+                      data->current_parameters.plla.clock_source << 2;
+    si5351_shadow_set(data, SI5351_REG_PLL_CFG_ADR, pll_cfg);
+
+    // Set the XTAL load
+    uint8_t xtal_load = data->current_parameters.xtal_load << 6 | 0x12; // Magic given from AN619
+    si5351_shadow_set(data, SI5351_REG_XTAL_LOAD_ADR, xtal_load);
+
+    // === Set clock output specific settings ===
+    // Absent outputs stay powered down and their multisynths are left untouched
+    for (int i = 0; i < data->num_outputs; i++)
+    {
+        if (data->outputs[i].output_present)
+        {
+            si5351_stage_output(data, i);
+        }
+        else
+        {
+            si5351_shadow_set(data, SI5351_REG_CLK_OUT_CTRL_ADR_BASE + i * SI5351_REG_CLK_OUT_CTRL_SIZE, 0x80);
+        }
+    }
+
+    // Set PLL multisynth settings
+    si5351_stage_pll(data, si5351_pll_mask_a | si5351_pll_mask_b);
+}
+#endif // CONFIG_CLOCK_CONTROL_SI5351_INIT_IMAGE
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_WARM_BOOT
+// After an MCU-only reset the device may still run the wanted configuration. Read it back in one
+// burst and only write the registers that differ, so running clocks are not interrupted.
+// Returns -EAGAIN when the device went through its own power-up and needs a full initialization.
+static int si5351_warm_boot(const struct device *dev)
+{
+    si5351_data_t *data = dev->data;
+    si5351_shadow_t *shadow = &data->shadow;
+
+    uint8_t status_register;
+    if (si5351_bus_read_byte(dev, SI5351_REG_STATUS_ADR, &status_register))
+    {
+        LOG_ERR("Could not read status register");
+        return -EIO;
+    }
+    if (status_register & SI5351_STATUS_SYS_INIT)
+    {
+        return -EAGAIN;
+    }
+
+    memset(shadow, 0, sizeof(*shadow));
+    si5351_shadow_set(data, SI5351_REG_OEB_MASK_ADR, 0xff);
+    si5351_shadow_set(data, SI5351_REG_INTERRUPT_MASK_ADR, si5351_interrupt_mask(dev));
+    si5351_stage_configuration(dev);
+    si5351_stage_oeb(data);
+
+    uint8_t first = 0;
+    uint8_t last = SI5351_REG_MAP_SIZE - 1;
+    while (!si5351_shadow_test(shadow->dirty, first))
+    {
+        first++;
+    }
+    while (!si5351_shadow_test(shadow->dirty, last))
+    {
+        last--;
+    }
+
+    uint8_t readback[SI5351_REG_MAP_SIZE];
+    if (si5351_bus_burst_read(dev, first, &readback[first], last - first + 1))
+    {
+        LOG_ERR("Could not read from device");
+        return -EIO;
+    }
+
+    si5351_pll_mask_t pll_changed = 0;
+    for (int reg = first; reg <= last; reg++)
+    {
+        if (!si5351_shadow_test(shadow->dirty, reg))
+        {
+            continue;
+        }
+
+        if (readback[reg] == shadow->regs[reg])
+        {
+            si5351_shadow_unmark(shadow->dirty, reg);
+            si5351_shadow_mark(shadow->valid, reg);
+        }
+        else if (reg >= SI5351_REG_PLL_X_ADR_BASE && reg < SI5351_REG_PLL_X_ADR_BASE + SI5351_REG_PLL_X_SIZE)
+        {
+            pll_changed |= si5351_pll_mask_a;
+        }
+        else if (reg >= SI5351_REG_PLL_X_ADR_BASE + SI5351_REG_PLL_X_SIZE &&
+                 reg < SI5351_REG_PLL_X_ADR_BASE + 2 * SI5351_REG_PLL_X_SIZE)
+        {
+            pll_changed |= si5351_pll_mask_b;
+        }
+    }
+
+    int ret = si5351_shadow_flush_range(dev, SI5351_REG_OEB_ADR + 1, SI5351_REG_MAP_SIZE);
+    if (ret)
+    {
+        return ret;
+    }
+
+    if (pll_changed)
+    {
+        ret = si5351_write_pll_reset(dev, pll_changed);
+    }
+    else
+    {
+        ret = si5351_wait_status_clear(dev, SI5351_STATUS_LOL_A | SI5351_STATUS_LOL_B);
+    }
+    if (ret)
+    {
+        return ret;
+    }
+
+    LOG_DBG("Warm boot, registers 0x%02x-0x%02x verified", first, last);
+
+    return si5351_shadow_flush_range(dev, 0, SI5351_REG_OEB_ADR + 1);
+}
+#endif // CONFIG_CLOCK_CONTROL_SI5351_WARM_BOOT
+
+#ifdef CONFIG_PM_DEVICE
+// The interrupt mask register powers up as 0x00 while the driver always masks SYS_INIT,
+// so a single byte tells whether the device kept its configuration
+static int si5351_registers_retained(const struct device *dev, bool *retained)
+{
+    si5351_data_t *data = dev->data;
+    uint8_t mask_register;
+
+    if (si5351_bus_read_byte(dev, SI5351_REG_INTERRUPT_MASK_ADR, &mask_register))
+    {
+        LOG_ERR("Could not read from device");
+        return -EIO;
+    }
+
+    *retained = mask_register == data->shadow.regs[SI5351_REG_INTERRUPT_MASK_ADR];
+    return 0;
+}
+
+// Rewrite a device that lost power from the register shadow instead of encoding the configuration
+// again. Every register the shadow knows is written once in contiguous runs, outputs are held off
+// until both PLLs have locked.
+static int si5351_restore_shadow(const struct device *dev)
+{
+    si5351_data_t *data = dev->data;
+    si5351_shadow_t *shadow = &data->shadow;
+
+    int ret = si5351_wait_status_clear(dev, SI5351_STATUS_SYS_INIT);
+    if (ret)
+    {
+        return ret;
+    }
+
+    for (int reg = SI5351_REG_INTERRUPT_MASK_ADR; reg < SI5351_REG_MAP_SIZE; reg++)
+    {
+        if (reg != SI5351_REG_PLL_RESET_ADR && si5351_shadow_test(shadow->valid, reg))
+        {
+            si5351_shadow_unmark(shadow->valid, reg);
+            si5351_shadow_mark(shadow->dirty, reg);
+        }
+    }
+
+    uint8_t oeb_register = shadow->regs[SI5351_REG_OEB_ADR];
+    si5351_shadow_set(data, SI5351_REG_OEB_ADR, 0xff);
+
+    ret = si5351_shadow_flush_range(dev, 0, SI5351_REG_OEB_ADR + 1);
+    if (ret)
+    {
+        return ret;
+    }
+
+    ret = si5351_shadow_flush_range(dev, SI5351_REG_OEB_ADR + 1, SI5351_REG_MAP_SIZE);
+    if (ret)
+    {
+        return ret;
+    }
+
+    ret = si5351_write_pll_reset(dev, si5351_pll_mask_a | si5351_pll_mask_b);
+    if (ret)
+    {
+        return ret;
+    }
+
+    si5351_shadow_set(data, SI5351_REG_OEB_ADR, oeb_register);
+    return si5351_shadow_flush_range(dev, 0, SI5351_REG_OEB_ADR + 1);
+}
+#endif // CONFIG_PM_DEVICE
+
+static int si5351_write_configuration(const struct device *dev)
+{
+    si5351_data_t *data = dev->data;
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_WARM_BOOT
+    int ret = si5351_warm_boot(dev);
+    if (ret != -EAGAIN)
+    {
+        return ret;
+    }
+#else
+    int ret;
+#endif
+
+    // Registers written before the device finished its own initialization are not retained
+    ret = si5351_wait_status_clear(dev, SI5351_STATUS_SYS_INIT);
+    if (ret)
+    {
+        return ret;
+    }
+
+    // Nothing is known about the device content yet, every staged register is written once
+    memset(&data->shadow, 0, sizeof(data->shadow));
+
+    // Disable OEB inputs
+    si5351_shadow_set(data, SI5351_REG_OEB_MASK_ADR, 0xff);
+
+    // Disable OEB
+    si5351_shadow_set(data, SI5351_REG_OEB_ADR, 0xff);
+
+    // Only the sources serviced through int-gpios are unmasked
+    si5351_shadow_set(data, SI5351_REG_INTERRUPT_MASK_ADR, si5351_interrupt_mask(dev));
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_INIT_IMAGE
+    // Outputs are held off by OEB while the image powers up their drivers, so everything goes out
+    // in one flush. Clearing the sticky bits joins the OEB and interrupt mask run.
+    si5351_shadow_set(data, SI5351_REG_INTERRUPT_ADR, 0x00);
+#else
+    // Power down all output drivers
+    for (int i = 0; i < data->num_outputs; i++)
+    {
+        si5351_shadow_set(data, SI5351_REG_CLK_OUT_CTRL_ADR_BASE + i * SI5351_REG_CLK_OUT_CTRL_SIZE, 0x80);
+    }
+
+    if (si5351_shadow_flush(dev))
+    {
+        return -EIO;
+    }
+
+    // Clear any sticy interrupt bits
+    if (si5351_bus_write_byte(dev, SI5351_REG_INTERRUPT_ADR, 0x00))
+    {
+        LOG_ERR("Could not write to device");
+        return -EIO;
+    }
+#endif
+
+    si5351_stage_configuration(dev);
+
+    if (si5351_shadow_flush(dev))
+    {
+        return -EIO;
+    }
+
+    // Reset PLLs, returns once both have locked
+    ret = si5351_reset_pll(dev, si5351_pll_mask_a | si5351_pll_mask_b);
+    if (ret)
+    {
+        return ret;
+    }
+
+    // Update OEB register
+    if (si5351_write_oeb(dev))
+    {
+        return -EIO;
+    }
+
+    return 0;
+}
+
+int si5351_register_read(const struct device *dev, uint8_t reg, uint8_t *buffer, size_t length)
+{
+    si5351_data_t *data = dev->data;
+
+    if (length == 0 || reg + length > SI5351_REG_MAP_SIZE)
+    {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    int ret = si5351_bus_burst_read(dev, reg, buffer, length);
+    k_mutex_unlock(&data->lock);
+
+    if (ret)
+    {
+        LOG_ERR("Could not read from device");
+        return -EIO;
+    }
+    return 0;
+}
+
+int si5351_register_write(const struct device *dev, uint8_t reg, uint8_t value)
+{
+    si5351_data_t *data = dev->data;
+    si5351_shadow_t *shadow = &data->shadow;
+
+    if (reg >= SI5351_REG_MAP_SIZE)
+    {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    int ret = si5351_bus_write_byte(dev, reg, value);
+    if (ret == 0 && reg != SI5351_REG_STATUS_ADR && reg != SI5351_REG_INTERRUPT_ADR && reg != SI5351_REG_PLL_RESET_ADR)
+    {
+        // Later diffs are against what was poked, the cached parameters are not updated
+        shadow->regs[reg] = value;
+        si5351_shadow_mark(shadow->valid, reg);
+        si5351_shadow_unmark(shadow->dirty, reg);
+    }
+    k_mutex_unlock(&data->lock);
+
+    if (ret)
+    {
+        LOG_ERR("Could not write to device");
+        return -EIO;
+    }
+    return 0;
+}
+
+int si5351_get_parameters(const struct device *dev, si5351_parameter_source_t source, si5351_parameters_t *parameters)
+{
+    si5351_data_t *data = dev->data;
+
+    if (source == si5351_parameter_source_cache)
+    {
+        atomic_val_t sequence;
+        do
+        {
+            sequence = si5351_state_read_begin(data);
+            memcpy(parameters, &data->current_parameters, sizeof(si5351_parameters_t));
+        } while (si5351_state_read_retry(data, sequence));
+        return 0;
+    }
+
+    uint8_t registers[SI5351_REG_MAP_SIZE];
+    k_mutex_lock(&data->lock, K_FOREVER);
+    int ret = si5351_read_registers(dev, registers);
+    k_mutex_unlock(&data->lock);
+    if (ret)
+    {
+        return ret;
+    }
+
+    uint8_t pll_cfg = registers[SI5351_REG_PLL_CFG_ADR];
+    parameters->clkin_div = (pll_cfg >> 6) & 0x03;
+    parameters->xtal_load = (registers[SI5351_REG_XTAL_LOAD_ADR] >> 6) & 0x03;
+
+    si5351_decode_pll(&registers[SI5351_REG_PLL_X_ADR_BASE], &parameters->plla);
+    parameters->plla.clock_source = (pll_cfg >> 2) & 0x01;
+    si5351_decode_pll(&registers[SI5351_REG_PLL_X_ADR_BASE + SI5351_REG_PLL_X_SIZE], &parameters->pllb);
+    parameters->pllb.clock_source = (pll_cfg >> 3) & 0x01;
+
+    return 0;
+}
+
+int si5351_set_parameters(const struct device *dev, si5351_parameters_t const *parameters)
+{
+    si5351_data_t *data = dev->data;
+
+    // The stage paths read the parameters under the lock only, the sequence is for lock-free readers
+    k_mutex_lock(&data->lock, K_FOREVER);
+    k_spinlock_key_t key = si5351_state_write_begin(data);
+    memcpy(&data->current_parameters, parameters, sizeof(si5351_parameters_t));
+    si5351_state_write_end(data, key);
+    k_mutex_unlock(&data->lock);
+
+    return 0;
+}
+
+int si5351_reset_pll(const struct device *dev, si5351_pll_mask_t pll)
+{
+    si5351_data_t *data = dev->data;
+    int ret = 0;
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    if (data->transaction_depth > 0)
+    {
+        // Merged into a single reset at commit
+        data->pending_pll_reset |= pll;
+    }
+    else
+    {
+        ret = si5351_write_pll_reset(dev, pll);
+    }
+    k_mutex_unlock(&data->lock);
+
+    return ret;
+}
+
+int si5351_transaction_begin(const struct device *dev)
+{
+    si5351_data_t *data = dev->data;
+
+    // Held until the matching commit so the transaction is atomic to other threads
+    k_mutex_lock(&data->lock, K_FOREVER);
+
+    if (data->transaction_depth == UINT8_MAX)
+    {
+        k_mutex_unlock(&data->lock);
+        return -EBUSY;
+    }
+
+    data->transaction_depth++;
+    return 0;
+}
+
+int si5351_transaction_commit(const struct device *dev)
+{
+    si5351_data_t *data = dev->data;
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+
+    if (data->transaction_depth == 0)
+    {
+        k_mutex_unlock(&data->lock);
+        LOG_ERR("No transaction to commit");
+        return -EINVAL;
+    }
+
+    int ret = 0;
+    if (--data->transaction_depth > 0)
+    {
+        // Nested, the outermost commit writes everything
+        goto out;
+    }
+
+    // Dividers and PLLs first, then a single PLL reset, then the OEB register last
+    // so outputs are only switched once the new configuration is in place
+    ret = si5351_shadow_flush_range(dev, SI5351_REG_OEB_ADR + 1, SI5351_REG_MAP_SIZE);
+    if (ret)
+    {
+        goto out;
+    }
+
+    if (data->pending_pll_reset)
+    {
+        ret = si5351_write_pll_reset(dev, data->pending_pll_reset);
+        if (ret)
+        {
+            goto out;
+        }
+        data->pending_pll_reset = 0;
+    }
+
+    ret = si5351_shadow_flush_range(dev, 0, SI5351_REG_OEB_ADR + 1);
+
+out:
+    // Once for this call and once for the lock taken in si5351_transaction_begin()
+    k_mutex_unlock(&data->lock);
+    k_mutex_unlock(&data->lock);
+    return ret;
+}
+
+int si5351_group_begin(si5351_group_t const *group)
+{
+    for (size_t i = 0; i < group->num_devices; i++)
+    {
+        int ret = si5351_transaction_begin(group->devices[i]);
+        if (ret)
+        {
+            // Roll back the members already locked
+            while (i-- > 0)
+            {
+                si5351_data_t *data = group->devices[i]->data;
+                data->transaction_depth--;
+                k_mutex_unlock(&data->lock);
+            }
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+int si5351_group_commit(si5351_group_t const *group)
+{
+    const struct device *const *devices = group->devices;
+    size_t num_devices = group->num_devices;
+    bool nested = false;
+    int ret = 0;
+
+    // Every member is checked under its own lock before anything is written. Members in a
+    // transaction are already held by this thread from si5351_group_begin().
+    for (size_t i = 0; i < num_devices; i++)
+    {
+        si5351_data_t *data = devices[i]->data;
+
+        k_mutex_lock(&data->lock, K_FOREVER);
+        if (data->transaction_depth == 0)
+        {
+            LOG_ERR("No transaction to commit on %s", devices[i]->name);
+            ret = -EINVAL;
+        }
+        nested |= data->transaction_depth > 1;
+    }
+
+    if (ret || nested)
+    {
+        // Left staged for the enclosing transactions
+        goto out;
+    }
+
+    // Same order as si5351_transaction_commit(), each step across all members before the next
+    ret = si5351_shadow_flush_range_group(devices, num_devices, SI5351_REG_OEB_ADR + 1, SI5351_REG_MAP_SIZE);
+    if (ret)
+    {
+        goto out;
+    }
+
+    // Resets go out back-to-back before any lock is awaited, so the skew between chips
+    // is one register write per member
+    for (size_t i = 0; i < num_devices; i++)
+    {
+        si5351_data_t *data = devices[i]->data;
+
+        if (data->pending_pll_reset)
+        {
+            ret = si5351_start_pll_reset(devices[i], data->pending_pll_reset);
+            if (ret)
+            {
+                goto out;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < num_devices; i++)
+    {
+        si5351_data_t *data = devices[i]->data;
+
+        if (data->pending_pll_reset)
+        {
+            ret = si5351_wait_pll_lock(devices[i], data->pending_pll_reset);
+            if (ret)
+            {
+                goto out;
+            }
+            data->pending_pll_reset = 0;
+        }
+    }
+
+    ret = si5351_shadow_flush_range_group(devices, num_devices, 0, SI5351_REG_OEB_ADR + 1);
+
+out:
+    // Members that were in a transaction end it even on error, so none is left locked
+    for (size_t i = 0; i < num_devices; i++)
+    {
+        si5351_data_t *data = devices[i]->data;
+
+        if (data->transaction_depth > 0)
+        {
+            data->transaction_depth--;
+            k_mutex_unlock(&data->lock);
+        }
+        k_mutex_unlock(&data->lock);
+    }
+    return ret;
+}
+
+int si5351_output_get_parameters(const struct device *dev, si5351_parameter_source_t source, si5351_output_parameters_t *parameters)
+{
+    const si5351_output_config_t *cfg = dev->config;
+    si5351_output_data_t *data = dev->data;
+    si5351_data_t *parent_data = cfg->parent->data;
+    uint8_t index = cfg->output_index;
+
+    if (source == si5351_parameter_source_cache)
+    {
+        atomic_val_t sequence;
+        do
+        {
+            sequence = si5351_state_read_begin(parent_data);
+            memcpy(parameters, &data->current_parameters, sizeof(si5351_output_parameters_t));
+        } while (si5351_state_read_retry(parent_data, sequence));
+        return 0;
+    }
+
+    uint8_t registers[SI5351_REG_MAP_SIZE];
+    k_mutex_lock(&parent_data->lock, K_FOREVER);
+    int ret = si5351_read_registers(cfg->parent, registers);
+    k_mutex_unlock(&parent_data->lock);
+    if (ret)
+    {
+        return ret;
+    }
+
+    parameters->output_enabled = (registers[SI5351_REG_OEB_ADR] >> index) & 0x01;
+
+    uint8_t clk_ctrl = registers[SI5351_REG_CLK_OUT_CTRL_ADR_BASE + index * SI5351_REG_CLK_OUT_CTRL_SIZE];
+    parameters->powered_up = (clk_ctrl >> 7) & 0x01;
+    parameters->integer_mode = (clk_ctrl >> 6) & 0x01;
+    parameters->multisynth_source = (clk_ctrl >> 5) & 0x01;
+    parameters->invert = (clk_ctrl >> 4) & 0x01;
+    parameters->clock_source = (clk_ctrl >> 2) & 0x03;
+    parameters->drive_strength = clk_ctrl & 0x03;
+
+    if (index >= SI5351_INTEGER_OUTPUT_FIRST)
+    {
+        uint8_t ratio = registers[SI5351_REG_CLK_OUT_INT_X_ADR_BASE + index - SI5351_INTEGER_OUTPUT_FIRST];
+        parameters->p1 = ratio >= 4 ? 128 * ratio - 512 : 0;
+        parameters->p2 = 0;
+        parameters->p3 = 1;
+        parameters->r = (registers[SI5351_REG_CLK_OUT_INT_R_ADR] >> SI5351_REG_CLK_OUT_INT_R_SHIFT(index)) & 0x07;
+        parameters->divide_by_four = false;
+        parameters->phase_offset = 0;
+    }
+    else
+    {
+        si5351_decode_multisynth(&registers[SI5351_REG_CLK_OUT_X_ADR_BASE + index * SI5351_REG_CLK_OUT_X_SIZE], parameters);
+        parameters->phase_offset = registers[SI5351_REG_CLK_OUT_PHASE_OFFSET_X_ADR_BASE + index * SI5351_REG_CLK_OUT_PHASE_OFFSET_X_SIZE] & 0x7f;
+    }
+
+    return 0;
+}
+
+// CLK6 and CLK7 only take even integer ratios, without divide by four or phase offset
+static bool si5351_output_parameters_valid(uint8_t index, si5351_output_parameters_t const *parameters)
+{
+    if (index < SI5351_INTEGER_OUTPUT_FIRST)
+    {
+        return true;
+    }
+
+    uint32_t ratio = (parameters->p1 + 512) / 128;
+    return parameters->p2 == 0 && (parameters->p1 + 512) % 128 == 0 && (ratio & 1) == 0 &&
+           ratio >= SI5351_MULTISYNTH_INT_DIV_MIN && ratio <= SI5351_MULTISYNTH_INT_DIV_MAX &&
+           !parameters->divide_by_four && parameters->phase_offset == 0;
+}
+
+int si5351_output_set_parameters(const struct device *dev, si5351_output_parameters_t const *parameters)
+{
+    const si5351_output_config_t *cfg = dev->config;
+    si5351_output_data_t *data = dev->data;
+    si5351_data_t *parent_data = cfg->parent->data;
+    int ret = 0;
+    SI5351_STATS_LATENCY_START(start);
+
+    if (!si5351_output_parameters_valid(cfg->output_index, parameters))
+    {
+        LOG_ERR("Output %d only supports even integer divide ratios", cfg->output_index);
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&parent_data->lock, K_FOREVER);
+
+    k_spinlock_key_t key = si5351_state_write_begin(parent_data);
+    memcpy(&data->current_parameters, parameters, sizeof(si5351_output_parameters_t));
+    si5351_state_write_end(parent_data, key);
+
+    // Not registered yet, the parameters are written during chip initialization
+    if (parent_data->outputs[cfg->output_index].output_present)
+    {
+        // Only the registers that actually changed are sent to the device
+        si5351_stage_output(parent_data, cfg->output_index);
+        si5351_stage_oeb(parent_data);
+
+        ret = si5351_apply_staged(cfg->parent);
+    }
+
+    k_mutex_unlock(&parent_data->lock);
+
+    SI5351_STATS_LATENCY(parent_data, set_params, start);
+    return ret;
+}
+
+static si5351_pll_parameters_t *si5351_get_pll(si5351_data_t *data, si5351_output_multisynth_source_t source)
+{
+    return source == si5351_output_multisynth_source_pllb ? &data->current_parameters.pllb : &data->current_parameters.plla;
+}
+
+// Input frequency of a PLL in milli-Hz, the caller holds the lock or a state snapshot
+static int si5351_get_pll_reference(uint64_t xtal_frequency, si5351_pll_parameters_t const *pll, uint64_t *frequency)
+{
+    if (pll->clock_source != si5351_pll_clock_source_xtal)
+    {
+        LOG_ERR("Frequency planning from CLKIN is not supported");
+        return -ENOTSUP;
+    }
+
+    *frequency = xtal_frequency;
+    return 0;
+}
+
+// Whether any powered multisynth output outside output_mask depends on the given PLL
+static bool si5351_is_pll_shared(si5351_data_t *data, uint8_t output_mask, si5351_output_multisynth_source_t source)
+{
+    for (int i = 0; i < data->num_outputs; i++)
+    {
+        if ((output_mask & BIT(i)) || !data->outputs[i].output_present)
+        {
+            continue;
+        }
+
+        si5351_output_parameters_t const *clock_parameters = data->outputs[i].current_parameters;
+        if (clock_parameters->powered_up == si5351_output_powered_up &&
+            clock_parameters->clock_source == si5351_output_clk_source_multisynth &&
+            clock_parameters->multisynth_source == source)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static int si5351_output_set_frequency_locked(const struct device *dev, uint64_t frequency)
+{
+    const si5351_output_config_t *cfg = dev->config;
+    si5351_output_data_t *data = dev->data;
+    si5351_data_t *parent_data = cfg->parent->data;
+
+    si5351_output_parameters_t parameters = data->current_parameters;
+    si5351_pll_parameters_t *pll = si5351_get_pll(parent_data, parameters.multisynth_source);
+    si5351_pll_parameters_t new_pll = *pll;
+
+    uint64_t ref_frequency;
+    int ret = si5351_get_pll_reference(parent_data->xtal_frequency, pll, &ref_frequency);
+    if (ret)
+    {
+        return ret;
+    }
+
+    // A PLL feeding other outputs keeps its frequency, only this multisynth is solved then
+    bool pll_shared = si5351_is_pll_shared(parent_data, BIT(cfg->output_index), parameters.multisynth_source);
+    bool integer_only = cfg->output_index >= SI5351_INTEGER_OUTPUT_FIRST;
+    ret = si5351_solve_output(ref_frequency, frequency, pll_shared, integer_only, &new_pll, &parameters);
+    if (ret)
+    {
+        LOG_ERR("No divider plan for %" PRIu64 " mHz", frequency);
+        return ret;
+    }
+
+    bool pll_changed = new_pll.p1 != pll->p1 || new_pll.p2 != pll->p2 || new_pll.p3 != pll->p3;
+    si5351_pll_mask_t pll_mask = parameters.multisynth_source == si5351_output_multisynth_source_pllb ? si5351_pll_mask_b
+                                                                                                     : si5351_pll_mask_a;
+
+    k_spinlock_key_t key = si5351_state_write_begin(parent_data);
+    memcpy(&data->current_parameters, &parameters, sizeof(si5351_output_parameters_t));
+    *pll = new_pll;
+    si5351_state_write_end(parent_data, key);
+
+    if (!parent_data->outputs[cfg->output_index].output_present)
+    {
+        return 0;
+    }
+
+    si5351_stage_output(parent_data, cfg->output_index);
+    if (pll_changed)
+    {
+        si5351_stage_pll(parent_data, pll_mask);
+    }
+
+    ret = si5351_apply_staged(cfg->parent);
+    if (ret)
+    {
+        return ret;
+    }
+
+    if (pll_changed)
+    {
+        return si5351_reset_pll(cfg->parent, pll_mask);
+    }
+
+    return 0;
+}
+
+int si5351_output_set_frequency(const struct device *dev, uint64_t frequency)
+{
+    const si5351_output_config_t *cfg = dev->config;
+    si5351_data_t *parent_data = cfg->parent->data;
+
+    // Solve and write under one lock so the PLL sharing decision stays valid
+    k_mutex_lock(&parent_data->lock, K_FOREVER);
+    int ret = si5351_output_set_frequency_locked(dev, frequency);
+    k_mutex_unlock(&parent_data->lock);
+
+    return ret;
+}
+
+int si5351_output_get_frequency(const struct device *dev, uint64_t *frequency)
+{
+    const si5351_output_config_t *cfg = dev->config;
+    si5351_output_data_t *data = dev->data;
+    si5351_data_t *parent_data = cfg->parent->data;
+    si5351_output_parameters_t parameters;
+    si5351_pll_parameters_t pll;
+    uint64_t xtal_frequency;
+    atomic_val_t sequence;
+
+    // Consistent snapshot of the multisynth, the PLL feeding it and the reference
+    do
+    {
+        sequence = si5351_state_read_begin(parent_data);
+        parameters = data->current_parameters;
+        pll = *si5351_get_pll(parent_data, parameters.multisynth_source);
+        xtal_frequency = parent_data->xtal_frequency;
+    } while (si5351_state_read_retry(parent_data, sequence));
+
+    uint64_t ref_frequency;
+    int ret;
+
+    switch (parameters.clock_source)
+    {
+    case si5351_output_clk_source_xtal:
+        *frequency = xtal_frequency >> parameters.r;
+        return 0;
+    case si5351_output_clk_source_multisynth:
+        ret = si5351_get_pll_reference(xtal_frequency, &pll, &ref_frequency);
+        if (ret)
+        {
+            return ret;
+        }
+        *frequency = si5351_multisynth_frequency(si5351_pll_frequency(ref_frequency, &pll), &parameters);
+        return 0;
+    default:
+        return -ENOTSUP;
+    }
+}
+
+int si5351_output_encode_hop_table(const struct device *dev, uint64_t const *frequencies, si5351_hop_entry_t *entries, size_t num_entries)
+{
+    const si5351_output_config_t *cfg = dev->config;
+    si5351_output_data_t *data = dev->data;
+    si5351_data_t *parent_data = cfg->parent->data;
+    si5351_output_parameters_t parameters;
+    si5351_pll_parameters_t pll;
+    uint64_t xtal_frequency;
+    atomic_val_t sequence;
+
+    do
+    {
+        sequence = si5351_state_read_begin(parent_data);
+        parameters = data->current_parameters;
+        pll = *si5351_get_pll(parent_data, parameters.multisynth_source);
+        xtal_frequency = parent_data->xtal_frequency;
+    } while (si5351_state_read_retry(parent_data, sequence));
+
+    if (parameters.clock_source != si5351_output_clk_source_multisynth)
+    {
+        LOG_ERR("Output %d is not driven by a multisynth", cfg->output_index);
+        return -EINVAL;
+    }
+
+    uint64_t ref_frequency;
+    int ret = si5351_get_pll_reference(xtal_frequency, &pll, &ref_frequency);
+    if (ret)
+    {
+        return ret;
+    }
+
+    for (size_t i = 0; i < num_entries; i++)
+    {
+        uint64_t vco_frequency = si5351_multisynth_vco_frequency(frequencies[i], &parameters);
+
+        entries[i].parameters.clock_source = pll.clock_source;
+        ret = si5351_solve_pll_fixed_denominator(ref_frequency, vco_frequency, SI5351_P3_MAX, &entries[i].parameters);
+        if (ret)
+        {
+            LOG_ERR("Hop frequency %" PRIu64 " mHz is out of the VCO range", frequencies[i]);
+            return ret;
+        }
+
+        si5351_encode_pll(&entries[i].parameters, entries[i].registers);
+    }
+
+    return 0;
+}
+
+int si5351_output_hop(const struct device *dev, si5351_hop_entry_t const *entry)
+{
+    const si5351_output_config_t *cfg = dev->config;
+    si5351_output_data_t *data = dev->data;
+    si5351_data_t *parent_data = cfg->parent->data;
+
+    k_mutex_lock(&parent_data->lock, K_FOREVER);
+
+    si5351_output_multisynth_source_t source = data->current_parameters.multisynth_source;
+
+    k_spinlock_key_t key = si5351_state_write_begin(parent_data);
+    *si5351_get_pll(parent_data, source) = entry->parameters;
+    si5351_state_write_end(parent_data, key);
+
+    // Unchanged bytes are dropped by the shadow, typically only P2 is sent
+    uint8_t pll_adr = SI5351_REG_PLL_X_ADR_BASE + (source == si5351_output_multisynth_source_pllb ? SI5351_REG_PLL_X_SIZE : 0);
+    si5351_shadow_set_burst(parent_data, pll_adr, entry->registers, SI5351_REG_PLL_X_SIZE);
+
+    int ret = si5351_apply_staged(cfg->parent);
+    k_mutex_unlock(&parent_data->lock);
+    return ret;
+}
+
+int si5351_set_frequency_coherent(const struct device *dev, uint64_t frequency, si5351_output_phase_t const *outputs,
+                                  size_t num_outputs)
+{
+    si5351_data_t *data = dev->data;
+    uint8_t output_mask = 0;
+    uint16_t max_phase = 0;
+
+    if (num_outputs == 0 || num_outputs > data->num_outputs)
+    {
+        return -EINVAL;
+    }
+
+    for (size_t i = 0; i < num_outputs; i++)
+    {
+        const si5351_output_config_t *output_cfg = outputs[i].output->config;
+
+        if (output_cfg->parent != dev || !data->outputs[output_cfg->output_index].output_present)
+        {
+            LOG_ERR("Output %s is not present on %s", outputs[i].output->name, dev->name);
+            return -ENODEV;
+        }
+        // Phase offsets are only supported for the first 6 clock outputs
+        if (output_cfg->output_index >= SI5351_INTEGER_OUTPUT_FIRST && outputs[i].phase % 180 != 0)
+        {
+            LOG_ERR("Output %d has no phase offset register", output_cfg->output_index);
+            return -ENOTSUP;
+        }
+
+        output_mask |= BIT(output_cfg->output_index);
+        max_phase = MAX(max_phase, outputs[i].phase % 180);
+    }
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+
+    si5351_output_data_t *first_data = outputs[0].output->data;
+    si5351_output_multisynth_source_t source = first_data->current_parameters.multisynth_source;
+    si5351_pll_mask_t pll_mask = source == si5351_output_multisynth_source_pllb ? si5351_pll_mask_b : si5351_pll_mask_a;
+    si5351_pll_parameters_t *pll = si5351_get_pll(data, source);
+    si5351_pll_parameters_t new_pll = *pll;
+    uint64_t ref_frequency;
+    uint32_t ms_div;
+    int ret;
+
+    if (si5351_is_pll_shared(data, output_mask, source))
+    {
+        LOG_ERR("PLL%c feeds outputs outside the coherent set", pll_mask == si5351_pll_mask_a ? 'A' : 'B');
+        ret = -EBUSY;
+        goto out;
+    }
+
+    ret = si5351_get_pll_reference(data->xtal_frequency, pll, &ref_frequency);
+    if (ret)
+    {
+        goto out;
+    }
+
+    uint32_t div_max = (output_mask >> SI5351_INTEGER_OUTPUT_FIRST) ? SI5351_MULTISYNTH_INT_DIV_MAX : SI5351_MULTISYNTH_DIV_MAX;
+    ret = si5351_solve_phase_coherent(ref_frequency, frequency, max_phase, div_max, &new_pll, &ms_div);
+    if (ret)
+    {
+        LOG_ERR("No phase coherent plan for %" PRIu64 " mHz", frequency);
+        goto out;
+    }
+
+    uint32_t p1, p2, p3;
+    si5351_ratio_to_parameters(ms_div, 0, 1, &p1, &p2, &p3);
+
+    k_spinlock_key_t key = si5351_state_write_begin(data);
+    *pll = new_pll;
+    for (size_t i = 0; i < num_outputs; i++)
+    {
+        si5351_output_data_t *output_data = outputs[i].output->data;
+        si5351_output_parameters_t *parameters = &output_data->current_parameters;
+        uint16_t phase = outputs[i].phase % 360;
+
+        parameters->p1 = p1;
+        parameters->p2 = p2;
+        parameters->p3 = p3;
+        parameters->r = si5351_output_r_1;
+        parameters->divide_by_four = false;
+        parameters->integer_mode = si5351_output_integer_mode_enabled;
+        parameters->clock_source = si5351_output_clk_source_multisynth;
+        parameters->multisynth_source = source;
+        parameters->invert = phase >= 180 ? si5351_output_invert_enabled : si5351_output_invert_disabled;
+        parameters->phase_offset = ((phase % 180) * ms_div + 45) / 90;
+    }
+    si5351_state_write_end(data, key);
+
+    // Multisynths only start in phase from a PLL reset issued after they were written,
+    // so the reset is always part of the commit, even when the PLL itself is unchanged
+    ret = si5351_transaction_begin(dev);
+    if (ret)
+    {
+        goto out;
+    }
+    si5351_stage_pll(data, pll_mask);
+    for (int i = 0; i < data->num_outputs; i++)
+    {
+        if (output_mask & BIT(i))
+        {
+            si5351_stage_output(data, i);
+        }
+    }
+    ret = si5351_reset_pll(dev, pll_mask);
+    if (ret)
+    {
+        LOG_ERR("Could not reset PLL%c", pll_mask == si5351_pll_mask_a ? 'A' : 'B');
+        // Still ends the transaction, the outputs are not in phase until the next reset
+        si5351_transaction_commit(dev);
+        goto out;
+    }
+    ret = si5351_transaction_commit(dev);
+
+out:
+    k_mutex_unlock(&data->lock);
+    return ret;
+}
+
+int si5351_set_xtal_correction(const struct device *dev, int32_t ppb)
+{
+    si5351_config_t const *cfg = dev->config;
+    si5351_data_t *data = dev->data;
+
+    if (ppb < -SI5351_XTAL_CORRECTION_PPB_MAX || ppb > SI5351_XTAL_CORRECTION_PPB_MAX)
+    {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+
+    uint64_t xtal_frequency = si5351_mul_div_round((uint64_t)cfg->dt_config.xtal_frequency * SI5351_MILLIHZ_PER_HZ,
+                                                   SI5351_PPB + ppb, SI5351_PPB);
+    si5351_pll_parameters_t pll[2] = {data->current_parameters.plla, data->current_parameters.pllb};
+    si5351_pll_mask_t pll_mask = 0;
+    int ret = 0;
+
+    // Unused PLLs are left alone, whatever is planned on them later sees the new reference
+    for (int i = 0; i < 2; i++)
+    {
+        si5351_output_multisynth_source_t source = i ? si5351_output_multisynth_source_pllb
+                                                     : si5351_output_multisynth_source_plla;
+        if (pll[i].clock_source != si5351_pll_clock_source_xtal || !si5351_is_pll_shared(data, 0, source))
+        {
+            continue;
+        }
+
+        uint64_t vco_frequency = si5351_pll_frequency(data->xtal_frequency, &pll[i]);
+        ret = si5351_solve_pll(xtal_frequency, vco_frequency, &pll[i]);
+        if (ret)
+        {
+            LOG_ERR("PLL%c out of range with %d ppb", i ? 'B' : 'A', (int)ppb);
+            goto out;
+        }
+        pll_mask |= BIT(i);
     }
 
-    return 0;
+    k_spinlock_key_t key = si5351_state_write_begin(data);
+    data->xtal_frequency = xtal_frequency;
+    data->xtal_correction_ppb = ppb;
+    data->current_parameters.plla = pll[0];
+    data->current_parameters.pllb = pll[1];
+    si5351_state_write_end(data, key);
+
+    // The shadow drops the unchanged bytes, a few ppm only move P2 and P3
+    si5351_stage_pll(data, pll_mask);
+    ret = si5351_apply_staged(dev);
+
+out:
+    k_mutex_unlock(&data->lock);
+    return ret;
 }
 
-int si5351_set_output(const struct device *dev, uint8_t output_index, si5351_output_output_t state)
+int si5351_get_xtal_frequency(const struct device *dev, uint64_t *frequency, int32_t *ppb)
 {
     si5351_data_t *data = dev->data;
+    atomic_val_t sequence;
 
-    if (output_index >= 8)
-    {
-        LOG_ERR("Invalid output index: %d", output_index);
-        return -EINVAL;
-    }
-
-    if (!data->outputs[output_index].output_present)
+    do
     {
-        LOG_ERR("Output %d is not present", output_index);
-        return -ENODEV;
-    }
-
-    data->outputs[output_index].current_parameters->output_enabled = state;
+        sequence = si5351_state_read_begin(data);
+        *frequency = data->xtal_frequency;
+        *ppb = data->xtal_correction_ppb;
+    } while (si5351_state_read_retry(data, sequence));
 
-    return si5351_write_oeb(dev);
+    return 0;
 }
 
-static int si5351_write_configuration(const struct device *dev)
+int si5351_plan_frequencies(const struct device *dev, si5351_output_request_t const *requests, size_t num_requests,
+                            si5351_frequency_plan_t *plan)
 {
-    si5351_config_t const *cfg = dev->config;
     si5351_data_t *data = dev->data;
-    struct i2c_dt_spec const *i2c = &cfg->i2c;
-
-    // Prepare a burst buffer for the maximum number of clocks, disregard variants for now
-    uint8_t i2c_burst_buffer[SI5351_REG_CLK_OUT_X_SIZE * 8];
+    si5351_allocation_t allocation[SI5351_FREQUENCY_PLAN_OUTPUTS_MAX];
+    uint8_t output_mask = 0;
 
-    // Disable OEB inputs
-    if (i2c_reg_write_byte_dt(i2c, SI5351_REG_OEB_MASK_ADR, 0xff))
+    if (num_requests == 0 || num_requests > data->num_outputs)
     {
-        LOG_ERR("Could not write to device");
-        return -EIO;
+        return -EINVAL;
     }
 
-    // Disable OEB
-    if (i2c_reg_write_byte_dt(i2c, SI5351_REG_OEB_ADR, 0xff))
+    for (size_t i = 0; i < num_requests; i++)
     {
-        LOG_ERR("Could not write to device");
-        return -EIO;
+        const si5351_output_config_t *output_cfg = requests[i].output->config;
+
+        if (output_cfg->parent != dev || !data->outputs[output_cfg->output_index].output_present)
+        {
+            LOG_ERR("Output %s is not present on %s", requests[i].output->name, dev->name);
+            return -ENODEV;
+        }
+        if (output_mask & BIT(output_cfg->output_index))
+        {
+            LOG_ERR("Output %d is requested twice", output_cfg->output_index);
+            return -EINVAL;
+        }
+        output_mask |= BIT(output_cfg->output_index);
     }
 
-    // Reset PLL settings
-    if (i2c_burst_write_dt(i2c, SI5351_REG_PLL_X_ADR_BASE, 0, SI5351_REG_PLL_X_SIZE * 2))
+    k_mutex_lock(&data->lock, K_FOREVER);
+
+    si5351_pll_parameters_t pll[2] = {data->current_parameters.plla, data->current_parameters.pllb};
+    si5351_pll_mask_t pinned = 0;
+    uint64_t ref_frequency;
+    int ret;
+
+    if (si5351_is_pll_shared(data, output_mask, si5351_output_multisynth_source_plla))
     {
-        LOG_ERR("Could not write to device");
-        return -EIO;
+        pinned |= si5351_pll_mask_a;
+    }
+    if (si5351_is_pll_shared(data, output_mask, si5351_output_multisynth_source_pllb))
+    {
+        pinned |= si5351_pll_mask_b;
     }
 
-    // Power down all output drivers
-    for (int i = 0; i < 8; i++)
+    // Outputs may move between PLLs, so both must run from the same reference
+    ret = si5351_get_pll_reference(data->xtal_frequency, &pll[0], &ref_frequency);
+    if (ret == 0)
     {
-        i2c_burst_buffer[i * SI5351_REG_CLK_OUT_CTRL_SIZE] = 0x80;
+        ret = si5351_get_pll_reference(data->xtal_frequency, &pll[1], &ref_frequency);
     }
-    if (i2c_burst_write_dt(i2c, SI5351_REG_CLK_OUT_CTRL_ADR_BASE, i2c_burst_buffer, SI5351_REG_CLK_OUT_CTRL_SIZE * 8))
+    if (ret)
     {
-        LOG_ERR("Could not write to device");
-        return -EIO;
+        goto out;
     }
 
-    // Mask all interrupts for now
-    if (i2c_reg_write_byte_dt(i2c, SI5351_REG_INTERRUPT_MASK_ADR, 0xf8))
+    for (size_t i = 0; i < num_requests; i++)
     {
-        LOG_ERR("Could not write to device");
-        return -EIO;
-    }
+        const si5351_output_config_t *output_cfg = requests[i].output->config;
+        si5351_output_data_t *output_data = requests[i].output->data;
 
-    k_busy_wait(1000 * 100);
+        allocation[i].frequency = requests[i].frequency;
+        allocation[i].integer_only = output_cfg->output_index >= SI5351_INTEGER_OUTPUT_FIRST;
+        allocation[i].pll = output_data->current_parameters.multisynth_source;
+        allocation[i].parameters = output_data->current_parameters;
+    }
 
-    // Clear any sticy interrupt bits
-    if (i2c_reg_write_byte_dt(i2c, SI5351_REG_INTERRUPT_ADR, 0x00))
+    ret = si5351_solve_allocation(ref_frequency, allocation, num_requests, pinned, pll, &plan->pll_reset);
+    if (ret)
     {
-        LOG_ERR("Could not write to device");
-        return -EIO;
+        LOG_ERR("No PLL allocation for the requested frequencies");
+        goto out;
     }
 
-    // Set PLL settings
-    uint8_t pll_cfg = data->current_parameters.clkin_div << 6 |
-                      data->current_parameters.pllb.clock_source << 3 |
-                      data->current_parameters.plla.clock_source << 2;
-    if (i2c_reg_write_byte_dt(i2c, SI5351_REG_PLL_CFG_ADR, pll_cfg))
+    plan->plla = pll[0];
+    plan->pllb = pll[1];
+    plan->num_fractional = 0;
+    plan->num_outputs = num_requests;
+    for (size_t i = 0; i < num_requests; i++)
     {
-        LOG_ERR("Could not write to device");
-        return -EIO;
+        plan->outputs[i] = requests[i].output;
+        plan->parameters[i] = allocation[i].parameters;
+        if (allocation[i].cost != si5351_allocation_cost_even)
+        {
+            plan->num_fractional++;
+        }
     }
 
-    // Set the XTAL load
-    uint8_t xtal_load = data->current_parameters.xtal_load << 6 | 0x12; // Magic given from AN619
-    if (i2c_reg_write_byte_dt(i2c, SI5351_REG_XTAL_LOAD_ADR, xtal_load))
+out:
+    k_mutex_unlock(&data->lock);
+    return ret;
+}
+
+int si5351_apply_frequency_plan(const struct device *dev, si5351_frequency_plan_t const *plan)
+{
+    si5351_data_t *data = dev->data;
+
+    if (plan->num_outputs == 0 || plan->num_outputs > SI5351_FREQUENCY_PLAN_OUTPUTS_MAX)
     {
-        LOG_ERR("Could not write to device");
-        return -EIO;
+        return -EINVAL;
     }
 
-    // === Set clock output specific settings ===
-    si5351_output_parameters_t const *clock_parameters;
+    k_mutex_lock(&data->lock, K_FOREVER);
 
-    // Set clock output phase offsets, only supported for the first 6 clock outputs
-    for (int i = 0; i < 6; i++)
+    // Only the divider path is taken from the plan, settings changed since planning are kept
+    si5351_output_parameters_t merged[SI5351_FREQUENCY_PLAN_OUTPUTS_MAX];
+    for (size_t i = 0; i < plan->num_outputs; i++)
     {
-        if (!data->outputs[i].output_present)
+        const si5351_output_config_t *output_cfg = plan->outputs[i]->config;
+        si5351_output_data_t *output_data = plan->outputs[i]->data;
+        si5351_output_parameters_t const *planned = &plan->parameters[i];
+
+        merged[i] = output_data->current_parameters;
+        merged[i].multisynth_source = planned->multisynth_source;
+        merged[i].clock_source = planned->clock_source;
+        merged[i].integer_mode = planned->integer_mode;
+        merged[i].p1 = planned->p1;
+        merged[i].p2 = planned->p2;
+        merged[i].p3 = planned->p3;
+        merged[i].r = planned->r;
+        merged[i].divide_by_four = planned->divide_by_four;
+
+        if (!si5351_output_parameters_valid(output_cfg->output_index, &merged[i]))
         {
-            memset(&i2c_burst_buffer[i * SI5351_REG_CLK_OUT_PHASE_OFFSET_X_SIZE], 0, SI5351_REG_CLK_OUT_PHASE_OFFSET_X_SIZE);
-            continue;
+            LOG_ERR("Output %d only supports even integer divide ratios", output_cfg->output_index);
+            k_mutex_unlock(&data->lock);
+            return -EINVAL;
         }
-        clock_parameters = data->outputs[i].current_parameters;
+    }
 
-        i2c_burst_buffer[i * SI5351_REG_CLK_OUT_PHASE_OFFSET_X_SIZE] = clock_parameters->phase_offset;
+    k_spinlock_key_t key = si5351_state_write_begin(data);
+    if (plan->pll_reset & si5351_pll_mask_a)
+    {
+        data->current_parameters.plla = plan->plla;
     }
-    if (i2c_burst_write_dt(i2c, SI5351_REG_CLK_OUT_PHASE_OFFSET_X_ADR_BASE, i2c_burst_buffer, 6 * SI5351_REG_CLK_OUT_PHASE_OFFSET_X_SIZE))
+    if (plan->pll_reset & si5351_pll_mask_b)
     {
-        LOG_ERR("Could not write to device");
-        return -EIO;
+        data->current_parameters.pllb = plan->pllb;
     }
-
-    // Set clock output multisynths
-    for (int i = 0; i < 8; i++)
+    for (size_t i = 0; i < plan->num_outputs; i++)
     {
-        if (!data->outputs[i].output_present)
-        {
-            memset(&i2c_burst_buffer[i * SI5351_REG_CLK_OUT_X_SIZE], 0, SI5351_REG_CLK_OUT_X_SIZE);
-            continue;
-        }
-        clock_parameters = data->outputs[i].current_parameters;
+        si5351_output_data_t *output_data = plan->outputs[i]->data;
 
-        i2c_burst_buffer[i * SI5351_REG_CLK_OUT_X_SIZE + SI5351_REG_CLK_OUT_X_P3M_OFFSET] = (clock_parameters->p3 & 0x00ff00) >> 8;
-        i2c_burst_buffer[i * SI5351_REG_CLK_OUT_X_SIZE + SI5351_REG_CLK_OUT_X_P3L_OFFSET] = (clock_parameters->p3 & 0x0000ff) >> 0;
-        i2c_burst_buffer[i * SI5351_REG_CLK_OUT_X_SIZE + SI5351_REG_CLK_OUT_X_P1H_OFFSET] = clock_parameters->r << 4 | (clock_parameters->divide_by_four ? 0x3 : 0x0) << 2 | (clock_parameters->p1 & 0x030000) >> 16;
-        i2c_burst_buffer[i * SI5351_REG_CLK_OUT_X_SIZE + SI5351_REG_CLK_OUT_X_P1M_OFFSET] = (clock_parameters->p1 & 0x00ff00) >> 8;
-        i2c_burst_buffer[i * SI5351_REG_CLK_OUT_X_SIZE + SI5351_REG_CLK_OUT_X_P1L_OFFSET] = (clock_parameters->p1 & 0x0000ff) >> 0;
-        i2c_burst_buffer[i * SI5351_REG_CLK_OUT_X_SIZE + SI5351_REG_CLK_OUT_X_P3HP2H_OFFSET] = (clock_parameters->p3 & 0x0f0000) >> (16 - 4) | (clock_parameters->p2 & 0x0f0000) >> 16;
-        i2c_burst_buffer[i * SI5351_REG_CLK_OUT_X_SIZE + SI5351_REG_CLK_OUT_X_P2M_OFFSET] = (clock_parameters->p2 & 0x00ff00) >> 8;
-        i2c_burst_buffer[i * SI5351_REG_CLK_OUT_X_SIZE + SI5351_REG_CLK_OUT_X_P2L_OFFSET] = (clock_parameters->p2 & 0x0000ff) >> 0;
+        output_data->current_parameters = merged[i];
     }
-    if (i2c_burst_write_dt(i2c, SI5351_REG_CLK_OUT_X_ADR_BASE, i2c_burst_buffer, 8 * SI5351_REG_CLK_OUT_X_SIZE))
+    si5351_state_write_end(data, key);
+
+    int ret = si5351_transaction_begin(dev);
+    if (ret)
     {
-        LOG_ERR("Could not write to device");
-        return -EIO;
+        goto out;
     }
-
-    // Set clock config
-    for (int i = 0; i < 8; i++)
+    si5351_stage_pll(data, plan->pll_reset);
+    for (size_t i = 0; i < plan->num_outputs; i++)
     {
-        if (!data->outputs[i].output_present)
-        {
-            memset(&i2c_burst_buffer[i * SI5351_REG_CLK_OUT_CTRL_SIZE], 0, SI5351_REG_CLK_OUT_CTRL_SIZE);
-            continue;
-        }
-        clock_parameters = data->outputs[i].current_parameters;
+        const si5351_output_config_t *output_cfg = plan->outputs[i]->config;
 
-        i2c_burst_buffer[i * SI5351_REG_CLK_OUT_CTRL_SIZE] = clock_parameters->powered_up << 7 |
-                                                             clock_parameters->integer_mode << 6 |
-                                                             clock_parameters->multisynth_source << 5 |
-                                                             clock_parameters->invert << 4 |
-                                                             clock_parameters->clock_source << 2 |
-                                                             clock_parameters->drive_strength << 0;
+        si5351_stage_output(data, output_cfg->output_index);
     }
-    if (i2c_burst_write_dt(i2c, SI5351_REG_CLK_OUT_CTRL_ADR_BASE, i2c_burst_buffer, 8 * SI5351_REG_CLK_OUT_CTRL_SIZE))
+    if (plan->pll_reset)
     {
-        LOG_ERR("Could not write to device");
-        return -EIO;
+        ret = si5351_reset_pll(dev, plan->pll_reset);
+        if (ret)
+        {
+            LOG_ERR("Could not reset PLLs");
+            si5351_transaction_commit(dev);
+            goto out;
+        }
     }
+    ret = si5351_transaction_commit(dev);
 
-    // Set PLL multisynth settings
-    i2c_burst_buffer[SI5351_REG_PLL_X_P3M_OFFSET] = (data->current_parameters.plla.p3 & 0x00ff00) >> 8;
-    i2c_burst_buffer[SI5351_REG_PLL_X_P3L_OFFSET] = (data->current_parameters.plla.p3 & 0x0000ff) >> 0;
-    i2c_burst_buffer[SI5351_REG_PLL_X_P1H_OFFSET] = (data->current_parameters.plla.p1 & 0x030000) >> 16;
-    i2c_burst_buffer[SI5351_REG_PLL_X_P1M_OFFSET] = (data->current_parameters.plla.p1 & 0x00ff00) >> 8;
-    i2c_burst_buffer[SI5351_REG_PLL_X_P1L_OFFSET] = (data->current_parameters.plla.p1 & 0x0000ff) >> 0;
-    i2c_burst_buffer[SI5351_REG_PLL_X_P3HP2H_OFFSET] = (data->current_parameters.plla.p3 & 0x0f0000) >> (16 - 4) | (data->current_parameters.plla.p2 & 0x0f0000) >> 16;
-    i2c_burst_buffer[SI5351_REG_PLL_X_P2M_OFFSET] = (data->current_parameters.plla.p2 & 0x00ff00) >> 8;
-    i2c_burst_buffer[SI5351_REG_PLL_X_P2L_OFFSET] = (data->current_parameters.plla.p2 & 0x0000ff) >> 0;
-
-    i2c_burst_buffer[SI5351_REG_PLL_X_SIZE + SI5351_REG_PLL_X_P3M_OFFSET] = (data->current_parameters.pllb.p3 & 0x00ff00) >> 8;
-    i2c_burst_buffer[SI5351_REG_PLL_X_SIZE + SI5351_REG_PLL_X_P3L_OFFSET] = (data->current_parameters.pllb.p3 & 0x0000ff) >> 0;
-    i2c_burst_buffer[SI5351_REG_PLL_X_SIZE + SI5351_REG_PLL_X_P1H_OFFSET] = (data->current_parameters.pllb.p1 & 0x030000) >> 16;
-    i2c_burst_buffer[SI5351_REG_PLL_X_SIZE + SI5351_REG_PLL_X_P1M_OFFSET] = (data->current_parameters.pllb.p1 & 0x00ff00) >> 8;
-    i2c_burst_buffer[SI5351_REG_PLL_X_SIZE + SI5351_REG_PLL_X_P1L_OFFSET] = (data->current_parameters.pllb.p1 & 0x0000ff) >> 0;
-    i2c_burst_buffer[SI5351_REG_PLL_X_SIZE + SI5351_REG_PLL_X_P3HP2H_OFFSET] = (data->current_parameters.pllb.p3 & 0x0f0000) >> (16 - 4) | (data->current_parameters.pllb.p2 & 0x0f0000) >> 16;
-    i2c_burst_buffer[SI5351_REG_PLL_X_SIZE + SI5351_REG_PLL_X_P2M_OFFSET] = (data->current_parameters.pllb.p2 & 0x00ff00) >> 8;
-    i2c_burst_buffer[SI5351_REG_PLL_X_SIZE + SI5351_REG_PLL_X_P2L_OFFSET] = (data->current_parameters.pllb.p2 & 0x0000ff) >> 0;
-
-    if (i2c_burst_write_dt(i2c, SI5351_REG_PLL_X_ADR_BASE, i2c_burst_buffer, SI5351_REG_PLL_X_SIZE * 2))
+out:
+    k_mutex_unlock(&data->lock);
+    return ret;
+}
+
+static int si5351_output_set_rate(const struct device *dev, clock_control_subsys_t subsys, clock_control_subsys_rate_t rate)
+{
+    return si5351_output_set_frequency(dev, (uint64_t)(uintptr_t)rate * SI5351_MILLIHZ_PER_HZ);
+}
+
+static int si5351_output_get_rate(const struct device *dev, clock_control_subsys_t subsys, uint32_t *rate)
+{
+    uint64_t frequency;
+
+    int ret = si5351_output_get_frequency(dev, &frequency);
+    if (ret)
     {
-        LOG_ERR("Could not write to device");
-        return -EIO;
+        return ret;
     }
 
-    // Reset PLLs
-    if (si5351_reset_pll(dev, si5351_pll_mask_a | si5351_pll_mask_b))
+    *rate = (frequency + SI5351_MILLIHZ_PER_HZ / 2) / SI5351_MILLIHZ_PER_HZ;
+    return 0;
+}
+
+static int si5351_output_on(const struct device *dev, clock_control_subsys_t subsys)
+{
+    const si5351_output_config_t *cfg = dev->config;
+    si5351_output_data_t *data = dev->data;
+    si5351_data_t *parent_data = cfg->parent->data;
+    LOG_DBG("SI5351_on entered");
+
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+    // Counted per consumer, the first one powers the output up
+    if (pm_device_runtime_is_enabled(dev))
     {
-        return -EIO;
+        return pm_device_runtime_get(dev);
     }
+#endif
 
-    // Update OEB register
-    if (si5351_write_oeb(dev))
+    k_mutex_lock(&parent_data->lock, K_FOREVER);
+
+    k_spinlock_key_t key = si5351_state_write_begin(parent_data);
+    data->current_parameters.output_enabled = si5351_output_output_enabled;
+    si5351_state_write_end(parent_data, key);
+
+    int ret = si5351_write_oeb(cfg->parent);
+    k_mutex_unlock(&parent_data->lock);
+    return ret;
+}
+
+static int si5351_output_off(const struct device *dev, clock_control_subsys_t subsys)
+{
+    const si5351_output_config_t *cfg = dev->config;
+    si5351_output_data_t *data = dev->data;
+    si5351_data_t *parent_data = cfg->parent->data;
+    LOG_DBG("SI5351_off entered");
+
+#ifdef CONFIG_PM_DEVICE_RUNTIME
+    // The last consumer powers the multisynth and driver down, not just the OEB bit
+    if (pm_device_runtime_is_enabled(dev))
     {
-        return -EIO;
+        return pm_device_runtime_put(dev);
     }
+#endif
 
-    return 0;
+    k_mutex_lock(&parent_data->lock, K_FOREVER);
+
+    k_spinlock_key_t key = si5351_state_write_begin(parent_data);
+    data->current_parameters.output_enabled = si5351_output_output_disabled;
+    si5351_state_write_end(parent_data, key);
+
+    int ret = si5351_write_oeb(cfg->parent);
+    k_mutex_unlock(&parent_data->lock);
+    return ret;
 }
 
-int si5351_get_parameters(const struct device *dev, si5351_parameters_t *parameters)
+#ifdef CONFIG_PM_DEVICE
+// A suspended output is disabled and has its multisynth and driver powered down
+static int si5351_output_pm_action(const struct device *dev, enum pm_device_action action)
 {
-    return 0;
+    const si5351_output_config_t *cfg = dev->config;
+    si5351_output_data_t *data = dev->data;
+    si5351_output_parameters_t parameters;
+    int ret;
+
+    switch (action)
+    {
+    case PM_DEVICE_ACTION_RESUME:
+        if (!data->parent_claimed)
+        {
+            // Restores the chip first if it lost power while suspended
+            ret = pm_device_runtime_get(cfg->parent);
+            if (ret)
+            {
+                return ret;
+            }
+            data->parent_claimed = true;
+        }
+        si5351_output_get_parameters(dev, si5351_parameter_source_cache, &parameters);
+        parameters.powered_up = si5351_output_powered_up;
+        parameters.output_enabled = si5351_output_output_enabled;
+        return si5351_output_set_parameters(dev, &parameters);
+    case PM_DEVICE_ACTION_SUSPEND:
+        si5351_output_get_parameters(dev, si5351_parameter_source_cache, &parameters);
+        parameters.powered_up = si5351_output_powered_down;
+        parameters.output_enabled = si5351_output_output_disabled;
+        ret = si5351_output_set_parameters(dev, &parameters);
+        if (ret == 0 && data->parent_claimed)
+        {
+            data->parent_claimed = false;
+            ret = pm_device_runtime_put(cfg->parent);
+        }
+        return ret;
+    default:
+        return -ENOTSUP;
+    }
 }
 
-int si5351_set_parameters(const struct device *dev, si5351_parameters_t const *parameters)
+// Outputs power themselves down, the chip only tracks whether its registers survive
+static int si5351_pm_action(const struct device *dev, enum pm_device_action action)
 {
+    const si5351_config_t *cfg = dev->config;
     si5351_data_t *data = dev->data;
+    bool retained;
+    int ret = 0;
 
-    memcpy(&data->current_parameters, parameters, sizeof(si5351_parameters_t));
+    switch (action)
+    {
+    case PM_DEVICE_ACTION_SUSPEND:
+    case PM_DEVICE_ACTION_TURN_ON:
+        break;
+    case PM_DEVICE_ACTION_TURN_OFF:
+        data->registers_lost = true;
+        break;
+    case PM_DEVICE_ACTION_RESUME:
+        // Not configured yet, the last output to register writes everything
+        if (data->num_registered_clocks < cfg->num_okay_clocks)
+        {
+            break;
+        }
 
-    return 0;
+        k_mutex_lock(&data->lock, K_FOREVER);
+        if (!data->registers_lost)
+        {
+            ret = si5351_registers_retained(dev, &retained);
+            data->registers_lost = ret == 0 && !retained;
+        }
+        if (ret == 0 && data->registers_lost)
+        {
+            LOG_DBG("Restoring registers from the shadow");
+            ret = si5351_restore_shadow(dev);
+            data->registers_lost = ret != 0;
+        }
+        k_mutex_unlock(&data->lock);
+        break;
+    default:
+        return -ENOTSUP;
+    }
+
+    return ret;
 }
+#endif // CONFIG_PM_DEVICE
 
-int si5351_reset_pll(const struct device *dev, si5351_pll_mask_t pll)
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_WORK_Q
+// Dedicated work queue so driver work never waits behind unrelated system work, and system work
+// never waits behind a transaction holding the driver lock
+static K_KERNEL_STACK_DEFINE(si5351_work_q_stack, CONFIG_CLOCK_CONTROL_SI5351_WORK_Q_STACK_SIZE);
+struct k_work_q si5351_work_q;
+
+static void si5351_work_q_start(void)
 {
-    si5351_config_t const *cfg = dev->config;
-    struct i2c_dt_spec const *i2c = &cfg->i2c;
+    static bool started;
 
-    uint8_t pll_reset_register = 0;
-    pll_reset_register |= (pll & si5351_pll_mask_b) ? 0x80 : 0x00;
-    pll_reset_register |= (pll & si5351_pll_mask_a) ? 0x20 : 0x00;
+    if (started)
+    {
+        return;
+    }
 
-    if (i2c_reg_write_byte_dt(i2c, SI5351_REG_PLL_RESET_ADR, pll_reset_register))
+    k_work_queue_start(&si5351_work_q, si5351_work_q_stack, K_KERNEL_STACK_SIZEOF(si5351_work_q_stack),
+                       CONFIG_CLOCK_CONTROL_SI5351_WORK_Q_PRIORITY, NULL);
+    k_thread_name_set(&si5351_work_q.thread, "si5351_workq");
+    started = true;
+}
+#endif // CONFIG_CLOCK_CONTROL_SI5351_WORK_Q
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_ASYNC
+static void si5351_raise_signal(struct k_poll_signal *signal, int result)
+{
+    if (signal != NULL)
     {
-        LOG_ERR("Could not write to device");
-        return -EIO;
+        k_poll_signal_raise(signal, result);
     }
-    return 0;
 }
 
-int si5351_output_get_parameters(const struct device *dev, si5351_output_parameters_t *parameters)
+static void si5351_output_on_work_handler(struct k_work *work)
 {
-    return 0;
+    si5351_output_async_t *async = CONTAINER_OF(work, si5351_output_async_t, on_work);
+    clock_control_cb_t callback;
+    void *user_data;
+
+    k_spinlock_key_t key = k_spin_lock(&async->lock);
+    callback = async->on_callback;
+    user_data = async->on_user_data;
+    k_spin_unlock(&async->lock, key);
+
+    // The callback tells the consumer the clock runs, a failed write must not fire it
+    int ret = si5351_output_on(async->dev, NULL);
+    if (ret)
+    {
+        LOG_ERR("Could not enable output: %d", ret);
+        return;
+    }
+
+    if (callback != NULL)
+    {
+        callback(async->dev, NULL, user_data);
+    }
 }
 
-int si5351_output_set_parameters(const struct device *dev, si5351_output_parameters_t const *parameters)
+static void si5351_output_set_work_handler(struct k_work *work)
 {
-    si5351_output_data_t *data = dev->data;
+    si5351_output_async_t *async = CONTAINER_OF(work, si5351_output_async_t, set_work);
+    si5351_output_parameters_t parameters;
+    struct k_poll_signal *signal;
 
-    memcpy(&data->current_parameters, parameters, sizeof(si5351_output_parameters_t));
+    k_spinlock_key_t key = k_spin_lock(&async->lock);
+    parameters = async->pending_parameters;
+    signal = async->set_signal;
+    async->set_signal = NULL;
+    k_spin_unlock(&async->lock, key);
 
-    return 0;
+    si5351_raise_signal(signal, si5351_output_set_parameters(async->dev, &parameters));
 }
 
-static int si5351_output_on(const struct device *dev, clock_control_subsys_t subsys)
+static void si5351_tune_work_handler(struct k_work *work)
+{
+    si5351_async_t *async = CONTAINER_OF(work, si5351_async_t, tune_work);
+    si5351_pll_parameters_t plla, pllb;
+    si5351_pll_mask_t pll_mask;
+    struct k_poll_signal *signal;
+
+    k_spinlock_key_t key = k_spin_lock(&async->lock);
+    plla = async->plla;
+    pllb = async->pllb;
+    pll_mask = async->pll_mask;
+    signal = async->tune_signal;
+    async->pll_mask = 0;
+    async->tune_signal = NULL;
+    k_spin_unlock(&async->lock, key);
+
+    // Both PLLs may have been queued with different settings, write them together
+    int ret = si5351_transaction_begin(async->dev);
+    if (ret)
+    {
+        LOG_ERR("Could not begin transaction");
+        si5351_raise_signal(signal, ret);
+        return;
+    }
+    if (pll_mask & si5351_pll_mask_a)
+    {
+        ret = si5351_tune_pll(async->dev, si5351_pll_mask_a, &plla);
+    }
+    if (ret == 0 && (pll_mask & si5351_pll_mask_b))
+    {
+        ret = si5351_tune_pll(async->dev, si5351_pll_mask_b, &pllb);
+    }
+
+    // Always ends the transaction, the first error is the one reported
+    int commit_ret = si5351_transaction_commit(async->dev);
+    si5351_raise_signal(signal, ret ? ret : commit_ret);
+}
+
+static int si5351_output_async_on(const struct device *dev, clock_control_subsys_t subsys,
+                                  clock_control_cb_t callback, void *user_data)
 {
     const si5351_output_config_t *cfg = dev->config;
     si5351_output_data_t *data = dev->data;
-    LOG_DBG("SI5351_on entered");
+    si5351_data_t *parent_data = cfg->parent->data;
+    si5351_output_async_t *async = &data->async;
+    si5351_output_output_t output_enabled;
+    atomic_val_t sequence;
+    int ret;
+
+    // Never waits for the driver lock, a running transaction could hold it for a PLL lock time
+    do
+    {
+        sequence = si5351_state_read_begin(parent_data);
+        output_enabled = data->current_parameters.output_enabled;
+    } while (si5351_state_read_retry(parent_data, sequence));
 
-    data->current_parameters.output_enabled = si5351_output_output_enabled;
+    k_spinlock_key_t key = k_spin_lock(&async->lock);
+    if (output_enabled == si5351_output_output_enabled || k_work_busy_get(&async->on_work) != 0)
+    {
+        ret = -EALREADY;
+    }
+    else
+    {
+        async->on_callback = callback;
+        async->on_user_data = user_data;
+        ret = k_work_submit_to_queue(&si5351_work_q, &async->on_work);
+    }
+    k_spin_unlock(&async->lock, key);
 
-    si5351_write_oeb(cfg->parent);
-    return 0;
+    return ret < 0 ? ret : 0;
 }
 
-static int si5351_output_off(const struct device *dev, clock_control_subsys_t subsys)
+// Latest request wins, a request replaced before it was written completes with -ECANCELED
+int si5351_output_set_parameters_async(const struct device *dev, si5351_output_parameters_t const *parameters,
+                                       struct k_poll_signal *signal)
 {
-    const si5351_output_config_t *cfg = dev->config;
     si5351_output_data_t *data = dev->data;
-    LOG_DBG("SI5351_off entered");
+    si5351_output_async_t *async = &data->async;
+    struct k_poll_signal *replaced;
 
-    data->current_parameters.output_enabled = si5351_output_output_disabled;
+    k_spinlock_key_t key = k_spin_lock(&async->lock);
+    async->pending_parameters = *parameters;
+    replaced = async->set_signal;
+    async->set_signal = signal;
+    k_spin_unlock(&async->lock, key);
 
-    si5351_write_oeb(cfg->parent);
-    return 0;
+    if (replaced != signal)
+    {
+        si5351_raise_signal(replaced, -ECANCELED);
+    }
+
+    int ret = k_work_submit_to_queue(&si5351_work_q, &async->set_work);
+    return ret < 0 ? ret : 0;
+}
+
+int si5351_tune_pll_async(const struct device *dev, si5351_pll_mask_t pll_mask, si5351_pll_parameters_t const *parameters,
+                          struct k_poll_signal *signal)
+{
+    si5351_data_t *data = dev->data;
+    si5351_async_t *async = &data->async;
+    struct k_poll_signal *replaced;
+
+    k_spinlock_key_t key = k_spin_lock(&async->lock);
+    if (pll_mask & si5351_pll_mask_a)
+    {
+        async->plla = *parameters;
+    }
+    if (pll_mask & si5351_pll_mask_b)
+    {
+        async->pllb = *parameters;
+    }
+    async->pll_mask |= pll_mask;
+    replaced = async->tune_signal;
+    async->tune_signal = signal;
+    k_spin_unlock(&async->lock, key);
+
+    if (replaced != signal)
+    {
+        si5351_raise_signal(replaced, -ECANCELED);
+    }
+
+    int ret = k_work_submit_to_queue(&si5351_work_q, &async->tune_work);
+    return ret < 0 ? ret : 0;
 }
+#endif // CONFIG_CLOCK_CONTROL_SI5351_ASYNC
 
 static int si5351_setup(const struct device *dev)
 {
     const si5351_config_t *cfg = dev->config;
 
     uint8_t status;
-    if (i2c_reg_read_byte_dt(&cfg->i2c, SI5351_REG_STATUS_ADR, &status))
+    if (si5351_bus_read_byte(dev, SI5351_REG_STATUS_ADR, &status))
     {
         LOG_ERR("Could not read from device at 0x%" PRIX16, cfg->i2c.addr);
         return -EIO;
@@ -442,7 +2669,25 @@ static inline int parse_output_dt_parameters(si5351_output_dt_config_t const *de
         return -EINVAL;
     }
 
-    config_out->drive_strength = default_config_in->drive_strength;
+    switch (default_config_in->drive_strength)
+    {
+    case 2:
+        config_out->drive_strength = si5351_output_drive_strength_2ma;
+        break;
+    case 4:
+        config_out->drive_strength = si5351_output_drive_strength_4ma;
+        break;
+    case 6:
+        config_out->drive_strength = si5351_output_drive_strength_6ma;
+        break;
+    case 8:
+        config_out->drive_strength = si5351_output_drive_strength_8ma;
+        break;
+    default:
+        LOG_ERR("Invalid argument: drive_strength: %d", (int)default_config_in->drive_strength);
+        return -EINVAL;
+    }
+
     config_out->p1 = default_config_in->p1;
     config_out->p2 = default_config_in->p2;
     config_out->p3 = default_config_in->p3;
@@ -494,6 +2739,7 @@ static int si5351_register_output(const struct device *parent, const struct devi
     const si5351_output_config_t *clock_cfg = child->config;
 
     si5351_data_t *data = parent->data;
+    int ret = 0;
 
     data->outputs[clock_cfg->output_index].output_present = true;
     data->outputs[clock_cfg->output_index].current_parameters = child->data;
@@ -503,10 +2749,16 @@ static int si5351_register_output(const struct device *parent, const struct devi
     {
         // All clocks registered, perform chip initialization
         LOG_DBG("All outputs registered, performing chip initialization..");
-        si5351_write_configuration(parent);
+        k_mutex_lock(&data->lock, K_FOREVER);
+        ret = si5351_write_configuration(parent);
+        if (ret == 0)
+        {
+            si5351_interrupt_refresh(parent);
+        }
+        k_mutex_unlock(&data->lock);
     }
 
-    return 0;
+    return ret;
 }
 
 static int si5351_output_init(const struct device *dev)
@@ -520,6 +2772,12 @@ static int si5351_output_init(const struct device *dev)
         return -ENODEV;
     }
 
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_ASYNC
+    data->async.dev = dev;
+    k_work_init(&data->async.on_work, si5351_output_on_work_handler);
+    k_work_init(&data->async.set_work, si5351_output_set_work_handler);
+#endif
+
     if (parse_output_dt_parameters(&cfg->dt_config, &data->current_parameters) < 0)
     {
         LOG_ERR("Invalid argument");
@@ -552,7 +2810,12 @@ static int si5351_output_init(const struct device *dev)
             (int)data->current_parameters.divide_by_four,
             (int)data->current_parameters.phase_offset);
 
-    si5351_register_output(cfg->parent, dev);
+    int ret = si5351_register_output(cfg->parent, dev);
+    if (ret)
+    {
+        LOG_ERR("Chip initialization failed: %d", ret);
+        return ret;
+    }
 
     LOG_DBG("si5351_output_%d initialized", cfg->output_index);
     return 0;
@@ -595,10 +2858,12 @@ static int si5351_parse_dt_parameters(si5351_dt_config_t const *default_config_i
         return -EINVAL;
     };
 
+    config_out->plla.clock_source = default_config_in->plla.clock_source;
     config_out->plla.p1 = default_config_in->plla.p1;
     config_out->plla.p2 = default_config_in->plla.p2;
     config_out->plla.p3 = default_config_in->plla.p3;
 
+    config_out->pllb.clock_source = default_config_in->pllb.clock_source;
     config_out->pllb.p1 = default_config_in->pllb.p1;
     config_out->pllb.p2 = default_config_in->pllb.p2;
     config_out->pllb.p3 = default_config_in->pllb.p3;
@@ -620,6 +2885,17 @@ static int si5351_init(const struct device *dev)
         return -ENODEV;
     }
 
+    k_mutex_init(&data->lock);
+    atomic_set(&data->sequence, 0);
+    data->xtal_frequency = (uint64_t)cfg->dt_config.xtal_frequency * SI5351_MILLIHZ_PER_HZ;
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_STATS
+    if (STATS_INIT_AND_REG(data->stats, STATS_SIZE_32, dev->name))
+    {
+        LOG_WRN("Could not register statistics");
+    }
+#endif
+
     if (si5351_setup(dev) < 0)
     {
         LOG_ERR("Failed to setup device!");
@@ -628,6 +2904,23 @@ static int si5351_init(const struct device *dev)
 
     si5351_parse_dt_parameters(&cfg->dt_config, &data->current_parameters);
 
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_WORK_Q
+    si5351_work_q_start();
+#endif
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_INTERRUPT
+    if (si5351_has_interrupt(dev) && si5351_interrupt_init(dev))
+    {
+        LOG_ERR("Failed to setup interrupt");
+        return -EIO;
+    }
+#endif
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_ASYNC
+    data->async.dev = dev;
+    k_work_init(&data->async.tune_work, si5351_tune_work_handler);
+#endif
+
     LOG_DBG("clkin_div: %d\r\n"
             "xtal_load: %d\r\n"
             "plla.clock_source: %d\r\n"
@@ -657,10 +2950,14 @@ static int si5351_init(const struct device *dev)
 static DEVICE_API(clock_control, si5351_output_driver_api) = {
     .on = si5351_output_on,
     .off = si5351_output_off,
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_ASYNC
+    .async_on = si5351_output_async_on,
+#else
     .async_on = NULL,
-    .get_rate = NULL,
+#endif
+    .get_rate = si5351_output_get_rate,
     .get_status = NULL,
-    .set_rate = NULL,
+    .set_rate = si5351_output_set_rate,
     .configure = NULL,
 };
 
@@ -668,63 +2965,115 @@ static DEVICE_API(clock_control, si5351_output_driver_api) = {
 // This parses the options given in the device tree and assigns them to the
 // dt_config struct. The output_init function will copy this to the
 // data->current_config during runtime initialization
-#define SI5351_OUTPUT_INIT(child_node_id)                                       \
-    static si5351_output_data_t si5351_output_data##child_node_id;              \
-    static const si5351_output_config_t si5351_output_config##child_node_id = { \
-        .parent = DEVICE_DT_GET(DT_PARENT(child_node_id)),                      \
-        .output_index = DT_REG_ADDR(child_node_id),                             \
-        .dt_config = {                                                          \
-            .output_enabled = DT_PROP(child_node_id, output_enabled),           \
-            .powered_up = DT_PROP(child_node_id, powered_up),                   \
-            .integer_mode = DT_PROP(child_node_id, integer_mode),               \
-            .multisynth_source = DT_ENUM_IDX(child_node_id, multisynth_source), \
-            .invert = DT_PROP(child_node_id, invert),                           \
-            .clock_source = DT_ENUM_IDX(child_node_id, clock_source),           \
-            .drive_strength = DT_PROP(child_node_id, drive_strength),           \
-            .p1 = DT_PROP(child_node_id, p1),                                   \
-            .p2 = DT_PROP(child_node_id, p2),                                   \
-            .p3 = DT_PROP(child_node_id, p3),                                   \
-            .r = DT_PROP(child_node_id, r),                                     \
-            .divide_by_four = DT_PROP(child_node_id, divide_by_four),           \
-            .phase_offset = DT_PROP(child_node_id, phase_offset),               \
-        },                                                                      \
-    };                                                                          \
-    DEVICE_DT_DEFINE(child_node_id, &si5351_output_init, NULL,                  \
-                     &si5351_output_data##child_node_id,                        \
-                     &si5351_output_config##child_node_id, POST_KERNEL,         \
+#define SI5351_OUTPUT_INIT(child_node_id)                                                 \
+    BUILD_ASSERT(DT_REG_ADDR(child_node_id) <                                             \
+                     SI5351_DT_NUM_OUTPUTS(DT_PARENT(child_node_id)),                     \
+                 "Output number exceeds the outputs of the si5351 model");                \
+    static si5351_output_data_t si5351_output_data##child_node_id;                        \
+    static const si5351_output_config_t si5351_output_config##child_node_id = {           \
+        .parent = DEVICE_DT_GET(DT_PARENT(child_node_id)),                                \
+        .output_index = DT_REG_ADDR(child_node_id),                                       \
+        .dt_config = {                                                                    \
+            .output_enabled = DT_PROP(child_node_id, output_enabled),                     \
+            .powered_up = DT_PROP(child_node_id, powered_up),                             \
+            .integer_mode = SI5351_PLAN_OR(child_node_id, PLANNED, INTEGER_MODE,          \
+                                           DT_PROP(child_node_id, integer_mode)),         \
+            .multisynth_source = DT_ENUM_IDX(child_node_id, multisynth_source),           \
+            .invert = DT_PROP(child_node_id, invert),                                     \
+            .clock_source = DT_ENUM_IDX(child_node_id, clock_source),                     \
+            .drive_strength = DT_PROP(child_node_id, drive_strength),                     \
+            .p1 = SI5351_PLAN_OR(child_node_id, PLANNED, P1, DT_PROP(child_node_id, p1)), \
+            .p2 = SI5351_PLAN_OR(child_node_id, PLANNED, P2, DT_PROP(child_node_id, p2)), \
+            .p3 = SI5351_PLAN_OR(child_node_id, PLANNED, P3, DT_PROP(child_node_id, p3)), \
+            .r = SI5351_PLAN_OR(child_node_id, PLANNED, R, DT_PROP(child_node_id, r)),    \
+            .divide_by_four = SI5351_PLAN_OR(child_node_id, PLANNED, DIVIDE_BY_FOUR,      \
+                                             DT_PROP(child_node_id, divide_by_four)),     \
+            .phase_offset = DT_PROP(child_node_id, phase_offset),                         \
+        },                                                                                \
+    };                                                                                    \
+    PM_DEVICE_DT_DEFINE(child_node_id, si5351_output_pm_action);                          \
+    DEVICE_DT_DEFINE(child_node_id, &si5351_output_init, PM_DEVICE_DT_GET(child_node_id), \
+                     &si5351_output_data##child_node_id,                                  \
+                     &si5351_output_config##child_node_id, POST_KERNEL,                   \
                      SI5351_INIT_PRIORITY, &si5351_output_driver_api)
 
 // Macro, called once per si5351 instance
 // This parses the options given in the device tree and assigns them to the
 // dt_config struct. The output_init function will copy this to the
 // data->current_config during runtime initialization
-#define SI5351_INIT(inst)                                                  \
-    static si5351_data_t si5351_data_##inst;                               \
-    static const si5351_config_t si5351_config_##inst = {                  \
-        .i2c = I2C_DT_SPEC_INST_GET(inst),                                 \
-        .dt_config = {                                                     \
-            .clkin_div = DT_INST_PROP(inst, clkin_div),                    \
-            .xtal_load = DT_INST_PROP(inst, xtal_load),                    \
-            .plla = {                                                      \
-                .clock_source = DT_INST_ENUM_IDX(inst, plla_clock_source), \
-                .p1 = DT_INST_PROP(inst, plla_p1),                         \
-                .p2 = DT_INST_PROP(inst, plla_p2),                         \
-                .p3 = DT_INST_PROP(inst, plla_p3),                         \
-            },                                                             \
-            .pllb = {                                                      \
-                .clock_source = DT_INST_ENUM_IDX(inst, pllb_clock_source), \
-                .p1 = DT_INST_PROP(inst, pllb_p1),                         \
-                .p2 = DT_INST_PROP(inst, pllb_p2),                         \
-                .p3 = DT_INST_PROP(inst, pllb_p3),                         \
-            },                                                             \
-        },                                                                 \
-        .num_okay_clocks = DT_INST_CHILD_NUM_STATUS_OKAY(inst),            \
-    };                                                                     \
-    DEVICE_DT_INST_DEFINE(inst, &si5351_init, NULL,                        \
-                          &si5351_data_##inst,                             \
-                          &si5351_config_##inst, POST_KERNEL,              \
-                          SI5351_INIT_PRIORITY,                            \
-                          NULL);                                           \
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_RTIO
+#define SI5351_RTIO_DEFINE(inst)                                                                              \
+    I2C_DT_IODEV_DEFINE(si5351_iodev_##inst, DT_DRV_INST(inst));                                             \
+    RTIO_DEFINE(si5351_rtio_##inst, CONFIG_CLOCK_CONTROL_SI5351_RTIO_SQ_SIZE,                                \
+                CONFIG_CLOCK_CONTROL_SI5351_RTIO_SQ_SIZE);
+#define SI5351_RTIO_CONFIG(inst)                                                                              \
+    .rtio = &si5351_rtio_##inst,                                                                             \
+    .iodev = &si5351_iodev_##inst,
+#else
+#define SI5351_RTIO_DEFINE(inst)
+#define SI5351_RTIO_CONFIG(inst)
+#endif
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_INIT_IMAGE
+#define SI5351_INIT_IMAGE_DEFINE(inst)                                                                        \
+    static const uint8_t si5351_init_image_##inst[SI5351_REG_MAP_SIZE] = SI5351_PLAN(DT_DRV_INST(inst), IMAGE);
+#define SI5351_INIT_IMAGE_CONFIG(inst) \
+    .init_image = si5351_init_image_##inst,
+#else
+#define SI5351_INIT_IMAGE_DEFINE(inst)
+#define SI5351_INIT_IMAGE_CONFIG(inst)
+#endif
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_INTERRUPT
+#define SI5351_INTERRUPT_CONFIG(inst)                                                                         \
+    .int_gpio = GPIO_DT_SPEC_INST_GET_OR(inst, int_gpios, {0}),                                              \
+    .int_sources = SI5351_DT_INTERRUPT_SOURCES(DT_DRV_INST(inst)),
+#else
+#define SI5351_INTERRUPT_CONFIG(inst)
+#endif
+
+#define SI5351_INIT(inst)                                                                                    \
+    BUILD_ASSERT(SI5351_DT_HAS_CLKIN(DT_DRV_INST(inst)) ||                                                   \
+                     (DT_INST_ENUM_IDX(inst, plla_clock_source) == 0 &&                                      \
+                      DT_INST_ENUM_IDX(inst, pllb_clock_source) == 0),                                       \
+                 "Only the Si5351C has a CLKIN input");                                                      \
+    SI5351_RTIO_DEFINE(inst)                                                                                 \
+    SI5351_INIT_IMAGE_DEFINE(inst)                                                                           \
+    static si5351_children_t si5351_outputs_##inst[SI5351_DT_NUM_OUTPUTS(DT_DRV_INST(inst))];                \
+    static si5351_data_t si5351_data_##inst = {                                                              \
+        .outputs = si5351_outputs_##inst,                                                                    \
+        .num_outputs = ARRAY_SIZE(si5351_outputs_##inst),                                                    \
+    };                                                                                                       \
+    static const si5351_config_t si5351_config_##inst = {                                                    \
+        .i2c = I2C_DT_SPEC_INST_GET(inst),                                                                   \
+        SI5351_RTIO_CONFIG(inst)                                                                             \
+        SI5351_INIT_IMAGE_CONFIG(inst)                                                                       \
+        SI5351_INTERRUPT_CONFIG(inst)                                                                        \
+        .dt_config = {                                                                                       \
+            .xtal_frequency = DT_INST_PROP(inst, xtal_frequency),                                            \
+            .clkin_div = DT_INST_PROP(inst, clkin_div),                                                      \
+            .xtal_load = DT_INST_PROP(inst, xtal_load),                                                      \
+            .plla = {                                                                                        \
+                .clock_source = DT_INST_ENUM_IDX(inst, plla_clock_source),                                   \
+                .p1 = SI5351_PLAN_OR(DT_DRV_INST(inst), PLLA_PLANNED, PLLA_P1, DT_INST_PROP(inst, plla_p1)), \
+                .p2 = SI5351_PLAN_OR(DT_DRV_INST(inst), PLLA_PLANNED, PLLA_P2, DT_INST_PROP(inst, plla_p2)), \
+                .p3 = SI5351_PLAN_OR(DT_DRV_INST(inst), PLLA_PLANNED, PLLA_P3, DT_INST_PROP(inst, plla_p3)), \
+            },                                                                                               \
+            .pllb = {                                                                                        \
+                .clock_source = DT_INST_ENUM_IDX(inst, pllb_clock_source),                                   \
+                .p1 = SI5351_PLAN_OR(DT_DRV_INST(inst), PLLB_PLANNED, PLLB_P1, DT_INST_PROP(inst, pllb_p1)), \
+                .p2 = SI5351_PLAN_OR(DT_DRV_INST(inst), PLLB_PLANNED, PLLB_P2, DT_INST_PROP(inst, pllb_p2)), \
+                .p3 = SI5351_PLAN_OR(DT_DRV_INST(inst), PLLB_PLANNED, PLLB_P3, DT_INST_PROP(inst, pllb_p3)), \
+            },                                                                                               \
+        },                                                                                                   \
+        .num_okay_clocks = DT_INST_CHILD_NUM_STATUS_OKAY(inst),                                              \
+    };                                                                                                       \
+    PM_DEVICE_DT_INST_DEFINE(inst, si5351_pm_action);                                                        \
+    DEVICE_DT_INST_DEFINE(inst, &si5351_init, PM_DEVICE_DT_INST_GET(inst),                                   \
+                          &si5351_data_##inst,                                                               \
+                          &si5351_config_##inst, POST_KERNEL,                                                \
+                          SI5351_INIT_PRIORITY,                                                              \
+                          NULL);                                                                             \
     DT_INST_FOREACH_CHILD_STATUS_OKAY(inst, SI5351_OUTPUT_INIT)
 
 // Macro to call SI5351 for each instance in the device tree, provided by Zephyrs devicetree.h
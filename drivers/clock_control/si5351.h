@@ -9,13 +9,53 @@
 
 #include <stdint.h>
 #include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/clock_control.h>
 #include <zephyr/drivers/clock_control/si5351.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_RTIO
+#include <zephyr/rtio/rtio.h>
+
+// Each dirty run takes a register address and a data SQE
+#define SI5351_RTIO_MAX_RUNS (CONFIG_CLOCK_CONTROL_SI5351_RTIO_SQ_SIZE / 2)
+#endif
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_STATS
+#include <zephyr/stats/stats.h>
+#endif
+
+#ifdef CONFIG_PM_DEVICE
+#include <zephyr/pm/device.h>
+#include <zephyr/pm/device_runtime.h>
+#endif
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_INTERRUPT
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/sys/slist.h>
+#endif
+
+#include <si5351_plan.h>
 
 #define SI5351_INIT_PRIORITY CONFIG_CLOCK_CONTROL_SI5351_INIT_PRIORITY
 
+// Access to the build time frequency plan generated by scripts/gen_si5351_plan.py
+// Evaluates to the planned value if the node has one, otherwise to fallback
+#define SI5351_PLAN(node_id, name) UTIL_CAT(UTIL_CAT(SI5351_PLAN_ORD_, DT_DEP_ORD(node_id)), _##name)
+#define SI5351_PLAN_OR(node_id, flag, name, fallback) \
+    COND_CODE_1(SI5351_PLAN(node_id, flag), (SI5351_PLAN(node_id, name)), (fallback))
+
 #define SI5351_REG_STATUS_ADR 0x00
+#define SI5351_STATUS_SYS_INIT BIT(7)
+#define SI5351_STATUS_LOL_B BIT(6)
+#define SI5351_STATUS_LOL_A BIT(5)
+#define SI5351_STATUS_LOS_CLKIN BIT(4)
+#define SI5351_STATUS_LOS_XTAL BIT(3)
+#define SI5351_STATUS_REVID_MASK 0x03
 #define SI5351_REG_INTERRUPT_ADR 0x01
 #define SI5351_REG_INTERRUPT_MASK_ADR 0x02
+// Mask bits sit at the positions of their status bits, the low three bits are reserved
+#define SI5351_INTERRUPT_MASK_ALL 0xf8
 #define SI5351_REG_OEB_ADR 0x03
 #define SI5351_REG_OEB_MASK_ADR 0x09
 #define SI5351_REG_PLL_CFG_ADR 0x0f
@@ -45,15 +85,66 @@
 #define SI5351_REG_CLK_OUT_X_P2M_OFFSET 0x06
 #define SI5351_REG_CLK_OUT_X_P2L_OFFSET 0x07
 
+// CLK6 and CLK7 have integer-only multisynths, one divide ratio byte each and a shared R divider register
+#define SI5351_INTEGER_OUTPUT_FIRST 6
+#define SI5351_REG_CLK_OUT_INT_X_ADR_BASE 0x5a
+#define SI5351_REG_CLK_OUT_INT_R_ADR 0x5c
+#define SI5351_REG_CLK_OUT_INT_R_SHIFT(index) (((index) - SI5351_INTEGER_OUTPUT_FIRST) * 4)
+
 #define SI5351_REG_CLK_OUT_PHASE_OFFSET_X_ADR_BASE 0xa5
 #define SI5351_REG_CLK_OUT_PHASE_OFFSET_X_SIZE 0x01
 
-#define SI5351_REG_PLL_RESET_ADR 0x75
+#define SI5351_REG_PLL_RESET_ADR 0xb1
 #define SI5351_REG_XTAL_LOAD_ADR 0xb7
 #define SI5351_REG_FANOUT_ADR 0xbb
 
+// Span covering every configuration register, read back in one burst
+#define SI5351_REG_READBACK_FIRST SI5351_REG_OEB_ADR
+#define SI5351_REG_READBACK_LAST SI5351_REG_XTAL_LOAD_ADR
+
+// Outputs per package from the model devicetree property, only the Si5351C has a CLKIN input
+#define SI5351_NUM_OUTPUTS_MAX 8
+#define SI5351_DT_NUM_OUTPUTS(node_id)                                                  \
+    (DT_ENUM_HAS_VALUE(node_id, model, si5351a_b_gt) ? 3                                \
+     : (DT_ENUM_HAS_VALUE(node_id, model, si5351a_b_gm) ||                              \
+        DT_ENUM_HAS_VALUE(node_id, model, si5351b_b_gm) ||                              \
+        DT_ENUM_HAS_VALUE(node_id, model, si5351c_b_gm))                                \
+         ? SI5351_NUM_OUTPUTS_MAX                                                       \
+         : 4)
+#define SI5351_DT_HAS_CLKIN(node_id) \
+    (DT_ENUM_HAS_VALUE(node_id, model, si5351c_b_gm1) || DT_ENUM_HAS_VALUE(node_id, model, si5351c_b_gm))
+// Status bits serviced through the INTR pin, LOS of CLKIN only on parts that have the input
+#define SI5351_DT_INTERRUPT_SOURCES(node_id)                                            \
+    (SI5351_STATUS_LOL_A | SI5351_STATUS_LOL_B | SI5351_STATUS_LOS_XTAL |               \
+     (SI5351_DT_HAS_CLKIN(node_id) ? SI5351_STATUS_LOS_CLKIN : 0))
+
+// Size of the register map mirrored by the shadow, 0x00 - 0xbb
+#define SI5351_REG_MAP_SIZE 0xbc
+#define SI5351_SHADOW_WORDS DIV_ROUND_UP(SI5351_REG_MAP_SIZE, 32)
+
+// Frequency planning limits, frequencies in milli-Hz
+#define SI5351_MILLIHZ_PER_HZ 1000ULL
+#define SI5351_PLL_VCO_MIN (600000000ULL * SI5351_MILLIHZ_PER_HZ)
+#define SI5351_PLL_VCO_MAX (900000000ULL * SI5351_MILLIHZ_PER_HZ)
+#define SI5351_PLL_RATIO_MIN 15
+#define SI5351_PLL_RATIO_MAX 90
+#define SI5351_MULTISYNTH_DIV_MIN 8
+#define SI5351_MULTISYNTH_DIV_MAX 2048
+#define SI5351_MULTISYNTH_INT_DIV_MIN 6
+#define SI5351_MULTISYNTH_INT_DIV_MAX 254
+#define SI5351_MULTISYNTH_DIV_BY_4_MIN (150000000ULL * SI5351_MILLIHZ_PER_HZ)
+#define SI5351_OUTPUT_FREQUENCY_MIN (SI5351_PLL_VCO_MIN / (SI5351_MULTISYNTH_DIV_MAX * 128) + 1)
+#define SI5351_OUTPUT_FREQUENCY_MAX (200000000ULL * SI5351_MILLIHZ_PER_HZ)
+
+#define SI5351_PPB 1000000000LL
+#define SI5351_P3_MAX 0xfffff
+#define SI5351_PHASE_OFFSET_MAX 0x7f
+
+BUILD_ASSERT(SI5351_HOP_ENTRY_REGISTERS == SI5351_REG_PLL_X_SIZE, "Hop entries hold one PLL register block");
+
 typedef struct
 {
+    uint32_t xtal_frequency;
     uint8_t clkin_div;
     uint8_t xtal_load;
     si5351_pll_parameters_t plla;
@@ -83,23 +174,153 @@ typedef struct
     si5351_output_parameters_t *current_parameters;
 } si5351_children_t;
 
+// RAM copy of the device register map
+// dirty: byte has been changed in RAM but not yet written to the device
+// valid: byte is known to match the device contents
+typedef struct
+{
+    uint8_t regs[SI5351_REG_MAP_SIZE];
+    uint32_t dirty[SI5351_SHADOW_WORDS];
+    uint32_t valid[SI5351_SHADOW_WORDS];
+} si5351_shadow_t;
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_RTIO
+// Dirty runs of a flush in flight, kept until their completions are consumed
+typedef struct
+{
+    uint8_t next;
+    size_t num_runs;
+    uint8_t run_start[SI5351_RTIO_MAX_RUNS];
+    uint8_t run_length[SI5351_RTIO_MAX_RUNS];
+} si5351_rtio_batch_t;
+#endif
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_ASYNC
+// Queued PLL retune, serviced by the driver work queue
+typedef struct
+{
+    const struct device *dev;
+    struct k_work tune_work;
+    struct k_spinlock lock;
+    si5351_pll_mask_t pll_mask;
+    si5351_pll_parameters_t plla;
+    si5351_pll_parameters_t pllb;
+    struct k_poll_signal *tune_signal;
+} si5351_async_t;
+
+// Queued output enable and parameter change
 typedef struct
 {
+    const struct device *dev;
+    struct k_work on_work;
+    clock_control_cb_t on_callback;
+    void *on_user_data;
+    struct k_work set_work;
+    struct k_spinlock lock;
+    si5351_output_parameters_t pending_parameters;
+    struct k_poll_signal *set_signal;
+} si5351_output_async_t;
+#endif
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_INTERRUPT
+// Status register cache entry holding a value no armed source has changed since
+#define SI5351_INTERRUPT_STATUS_VALID BIT(8)
+
+// INTR pin service, the sticky register is only read when the pin fires
+typedef struct
+{
+    const struct device *dev;
+    struct gpio_callback gpio_callback;
+    struct k_work_delayable work;
+    // Status register with SI5351_INTERRUPT_STATUS_VALID, 0 once a source may have changed
+    atomic_t status;
+    // Sources unmasked on the device, a source is masked while its condition persists
+    uint8_t armed;
+    sys_slist_t callbacks;
+} si5351_interrupt_t;
+#endif
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_STATS
+// Latency histograms have log2 buckets in microseconds, bucket n counts calls
+// that took [2^(n-1), 2^n) us, the last bucket everything longer
+#define SI5351_STATS_LATENCY_BUCKETS 16
+#define SI5351_STATS_LATENCY_ENTRY(n, name) STATS_SECT_ENTRY32(name##_lat_##n)
+
+STATS_SECT_START(si5351_stats)
+STATS_SECT_ENTRY32(transactions)
+STATS_SECT_ENTRY32(bytes_written)
+STATS_SECT_ENTRY32(bytes_read)
+STATS_SECT_ENTRY32(io_errors)
+STATS_SECT_ENTRY32(pll_resets)
+LISTIFY(SI5351_STATS_LATENCY_BUCKETS, SI5351_STATS_LATENCY_ENTRY, (), tune_pll)
+LISTIFY(SI5351_STATS_LATENCY_BUCKETS, SI5351_STATS_LATENCY_ENTRY, (), set_params)
+STATS_SECT_END;
+#endif
+
+typedef struct
+{
+    // Serializes bus sequences and the register shadow, recursive so public calls may nest
+    struct k_mutex lock;
+    // Seqlock over current_parameters of the chip and its outputs, odd while an update is in progress
+    atomic_t sequence;
+    struct k_spinlock state_lock;
     si5351_parameters_t current_parameters;
-    si5351_children_t outputs[8];
+    // Crystal frequency in milli-Hz with the calibration applied, covered by the seqlock
+    uint64_t xtal_frequency;
+    int32_t xtal_correction_ppb;
+    si5351_shadow_t shadow;
+    uint8_t transaction_depth;
+    si5351_pll_mask_t pending_pll_reset;
+    // Sized per instance by the model
+    si5351_children_t *outputs;
+    uint8_t num_outputs;
     uint8_t num_registered_clocks;
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_RTIO
+    si5351_rtio_batch_t rtio_batch;
+#endif
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_ASYNC
+    si5351_async_t async;
+#endif
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_INTERRUPT
+    si5351_interrupt_t interrupt;
+#endif
+#ifdef CONFIG_PM_DEVICE
+    // Power was removed, the shadow holds the only copy of the configuration
+    bool registers_lost;
+#endif
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_STATS
+    STATS_SECT_DECL(si5351_stats) stats;
+#endif
 } si5351_data_t;
 
 typedef struct
 {
     struct i2c_dt_spec i2c;
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_RTIO
+    struct rtio *rtio;
+    struct rtio_iodev *iodev;
+#endif
     si5351_dt_config_t dt_config;
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_INIT_IMAGE
+    uint8_t const *init_image; // SI5351_REG_MAP_SIZE bytes, final OEB at SI5351_REG_OEB_ADR
+#endif
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_INTERRUPT
+    struct gpio_dt_spec int_gpio; // No port when the instance has no int-gpios
+    uint8_t int_sources;
+#endif
     uint8_t num_okay_clocks;
 } si5351_config_t;
 
 typedef struct
 {
     si5351_output_parameters_t current_parameters;
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_ASYNC
+    si5351_output_async_t async;
+#endif
+#ifdef CONFIG_PM_DEVICE
+    // Holds a runtime PM reference on the parent while resumed
+    bool parent_claimed;
+#endif
 } si5351_output_data_t;
 
 typedef struct
@@ -109,4 +330,51 @@ typedef struct
     si5351_output_dt_config_t dt_config;
 } si5351_output_config_t;
 
+// Multisynth cost of an output in the PLL allocation search
+typedef enum
+{
+    si5351_allocation_cost_even,       // Even integer ratio, integer mode
+    si5351_allocation_cost_odd,        // Odd integer ratio
+    si5351_allocation_cost_fractional,
+} si5351_allocation_cost_t;
+
+// One output of the PLL allocation search, frequency and integer_only in, the rest out
+typedef struct
+{
+    uint64_t frequency;
+    bool integer_only;
+    si5351_output_multisynth_source_t pll; // Current PLL on input, planned PLL on output
+    si5351_allocation_cost_t cost;
+    si5351_output_parameters_t parameters;
+} si5351_allocation_t;
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_WORK_Q
+// Driver work queue, keeps work that waits for the driver lock off the system work queue
+extern struct k_work_q si5351_work_q;
+#endif
+
+// Raw register access for diagnostics, keeps the register shadow coherent
+int si5351_register_read(const struct device *dev, uint8_t reg, uint8_t *buffer, size_t length);
+int si5351_register_write(const struct device *dev, uint8_t reg, uint8_t value);
+
+// si5351_solver.c
+uint64_t si5351_mul_div_round(uint64_t a, uint64_t b, uint64_t c);
+void si5351_best_rational(uint64_t num, uint64_t den, uint32_t max_den, uint32_t *b, uint32_t *c);
+void si5351_ratio_to_parameters(uint32_t a, uint32_t b, uint32_t c, uint32_t *p1, uint32_t *p2, uint32_t *p3);
+uint64_t si5351_pll_frequency(uint64_t ref_frequency, si5351_pll_parameters_t const *pll);
+uint64_t si5351_multisynth_frequency(uint64_t vco_frequency, si5351_output_parameters_t const *parameters);
+uint64_t si5351_multisynth_vco_frequency(uint64_t frequency, si5351_output_parameters_t const *parameters);
+int si5351_solve_pll(uint64_t ref_frequency, uint64_t vco_frequency, si5351_pll_parameters_t *pll);
+int si5351_solve_pll_fixed_p3(uint64_t ref_frequency, uint64_t vco_frequency, uint32_t p3, si5351_pll_parameters_t *pll);
+int si5351_solve_pll_fixed_denominator(uint64_t ref_frequency, uint64_t vco_frequency, uint32_t c,
+                                       si5351_pll_parameters_t *pll);
+int si5351_solve_output(uint64_t ref_frequency, uint64_t frequency, bool pll_fixed, bool integer_only,
+                        si5351_pll_parameters_t *pll, si5351_output_parameters_t *parameters);
+int si5351_solve_phase_coherent(uint64_t ref_frequency, uint64_t frequency, uint16_t max_phase, uint32_t div_max,
+                                si5351_pll_parameters_t *pll, uint32_t *ms_div);
+// Assign outputs to PLLA and PLLB and choose both VCO frequencies. pll holds the current PLLs
+// and receives the planned ones, PLLs in pinned keep their frequency.
+int si5351_solve_allocation(uint64_t ref_frequency, si5351_allocation_t *outputs, size_t num_outputs,
+                            si5351_pll_mask_t pinned, si5351_pll_parameters_t pll[2], si5351_pll_mask_t *pll_changed);
+
 #endif // ZEPHYR_DRIVERS_CLOCK_CONTROL_SI5351_H_
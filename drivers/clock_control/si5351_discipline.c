@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2025 Jonatan Gezelius
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Closed loop frequency discipline. A PI loop turns the measured output error into an offset of
+// the VCO frequency captured at start, written as P1/P2 at a fixed P3 through si5351_tune_pll(),
+// so the register shadow only sends the changed feedback divider bytes.
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/clock_control/si5351.h>
+
+#include "si5351.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(clock_control_si5351, CONFIG_CLOCK_CONTROL_LOG_LEVEL);
+
+// Unity gain of kp and ki
+#define SI5351_DISCIPLINE_GAIN_ONE 65536
+
+static int32_t si5351_discipline_max_correction(si5351_discipline_t const *discipline)
+{
+    return discipline->max_correction_ppb > 0 ? MIN(discipline->max_correction_ppb, SI5351_XTAL_CORRECTION_PPB_MAX)
+                                              : SI5351_XTAL_CORRECTION_PPB_MAX;
+}
+
+static void si5351_discipline_unlock(si5351_discipline_t *discipline)
+{
+    discipline->locked = false;
+    discipline->in_threshold = 0;
+}
+
+static int si5351_discipline_step(si5351_discipline_t *discipline)
+{
+    const si5351_output_config_t *cfg = discipline->output->config;
+    si5351_status_t status;
+    int32_t error_ppb;
+
+    int ret = discipline->measure(discipline->output, &error_ppb, discipline->user_data);
+    if (ret == -EAGAIN)
+    {
+        return 0;
+    }
+    if (ret)
+    {
+        si5351_discipline_unlock(discipline);
+        return ret;
+    }
+
+    // A measurement across a loss of lock says nothing about the loop, hold the last correction
+    ret = si5351_get_status(cfg->parent, &status);
+    if (ret)
+    {
+        return ret;
+    }
+    if ((discipline->pll_mask == si5351_pll_mask_a && status.plla_loss_of_lock) ||
+        (discipline->pll_mask == si5351_pll_mask_b && status.pllb_loss_of_lock))
+    {
+        si5351_discipline_unlock(discipline);
+        return 0;
+    }
+
+    int64_t max_correction = si5351_discipline_max_correction(discipline);
+    int64_t max_integrator = max_correction * SI5351_DISCIPLINE_GAIN_ONE;
+
+    discipline->integrator = CLAMP(discipline->integrator + (int64_t)discipline->ki * error_ppb,
+                                   -max_integrator, max_integrator);
+    int64_t correction = -((int64_t)discipline->kp * error_ppb + discipline->integrator) /
+                         SI5351_DISCIPLINE_GAIN_ONE;
+    correction = CLAMP(correction, -max_correction, max_correction);
+
+    uint64_t xtal_frequency;
+    int32_t xtal_correction_ppb;
+    si5351_parameters_t parameters;
+    si5351_get_xtal_frequency(cfg->parent, &xtal_frequency, &xtal_correction_ppb);
+    si5351_get_parameters(cfg->parent, si5351_parameter_source_cache, &parameters);
+
+    si5351_pll_parameters_t pll = discipline->pll_mask == si5351_pll_mask_a ? parameters.plla : parameters.pllb;
+    uint64_t vco_frequency = si5351_mul_div_round(discipline->vco_frequency, SI5351_PPB + correction, SI5351_PPB);
+    ret = si5351_solve_pll_fixed_p3(xtal_frequency, vco_frequency, SI5351_P3_MAX, &pll);
+    if (ret)
+    {
+        return ret;
+    }
+
+    ret = si5351_tune_pll(cfg->parent, discipline->pll_mask, &pll);
+    if (ret)
+    {
+        return ret;
+    }
+
+    discipline->residual_ppb = error_ppb;
+    discipline->correction_ppb = correction;
+    discipline->samples++;
+
+    if (error_ppb >= -discipline->lock_threshold_ppb && error_ppb <= discipline->lock_threshold_ppb)
+    {
+        if (discipline->in_threshold < discipline->lock_count)
+        {
+            discipline->in_threshold++;
+        }
+        discipline->locked = discipline->in_threshold >= discipline->lock_count;
+    }
+    else
+    {
+        si5351_discipline_unlock(discipline);
+    }
+
+    return 0;
+}
+
+static void si5351_discipline_work_handler(struct k_work *work)
+{
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    si5351_discipline_t *discipline = CONTAINER_OF(dwork, si5351_discipline_t, work);
+
+    int ret = si5351_discipline_step(discipline);
+    if (ret)
+    {
+        LOG_WRN("Discipline step failed (%d)", ret);
+    }
+
+    k_work_schedule_for_queue(&si5351_work_q, &discipline->work, K_MSEC(discipline->interval_ms));
+}
+
+int si5351_discipline_start(si5351_discipline_t *discipline)
+{
+    if (discipline->output == NULL || discipline->measure == NULL || discipline->interval_ms == 0)
+    {
+        return -EINVAL;
+    }
+
+    const si5351_output_config_t *cfg = discipline->output->config;
+    si5351_output_parameters_t output_parameters;
+    si5351_parameters_t parameters;
+    uint64_t xtal_frequency;
+    int32_t xtal_correction_ppb;
+
+    if (discipline->running)
+    {
+        return -EBUSY;
+    }
+
+    int ret = si5351_output_get_parameters(discipline->output, si5351_parameter_source_cache, &output_parameters);
+    if (ret)
+    {
+        return ret;
+    }
+    if (output_parameters.clock_source != si5351_output_clk_source_multisynth)
+    {
+        LOG_ERR("Output %d is not driven by a multisynth", cfg->output_index);
+        return -EINVAL;
+    }
+
+    ret = si5351_get_parameters(cfg->parent, si5351_parameter_source_cache, &parameters);
+    if (ret)
+    {
+        return ret;
+    }
+    ret = si5351_get_xtal_frequency(cfg->parent, &xtal_frequency, &xtal_correction_ppb);
+    if (ret)
+    {
+        return ret;
+    }
+
+    bool pllb = output_parameters.multisynth_source == si5351_output_multisynth_source_pllb;
+    si5351_pll_parameters_t const *pll = pllb ? &parameters.pllb : &parameters.plla;
+    if (pll->clock_source != si5351_pll_clock_source_xtal)
+    {
+        LOG_ERR("Discipline from CLKIN is not supported");
+        return -ENOTSUP;
+    }
+
+    discipline->pll_mask = pllb ? si5351_pll_mask_b : si5351_pll_mask_a;
+    discipline->vco_frequency = si5351_pll_frequency(xtal_frequency, pll);
+    discipline->integrator = 0;
+    discipline->in_threshold = 0;
+    discipline->locked = false;
+    discipline->residual_ppb = 0;
+    discipline->correction_ppb = 0;
+    discipline->samples = 0;
+
+    discipline->running = true;
+
+    k_work_init_delayable(&discipline->work, si5351_discipline_work_handler);
+    k_work_schedule_for_queue(&si5351_work_q, &discipline->work, K_MSEC(discipline->interval_ms));
+
+    return 0;
+}
+
+int si5351_discipline_stop(si5351_discipline_t *discipline)
+{
+    struct k_work_sync sync;
+
+    if (!discipline->running)
+    {
+        return -EALREADY;
+    }
+
+    // The PLL keeps the last correction
+    k_work_cancel_delayable_sync(&discipline->work, &sync);
+    discipline->running = false;
+
+    return 0;
+}
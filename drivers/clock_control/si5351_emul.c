@@ -0,0 +1,484 @@
+/*
+ * Copyright (c) 2025 Jonatan Gezelius
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// i2c_emul target for the si5351. Models the 0x00-0xbb register file with the auto-incrementing
+// address pointer, SYS_INIT after power-up, sticky status bits and PLL loss of lock after a reset.
+// Every transfer is counted so bus cost can be asserted in tests.
+
+#define DT_DRV_COMPAT skyworks_si5351
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/drivers/clock_control/si5351_emul.h>
+#ifdef CONFIG_GPIO_EMUL
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#endif
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include "si5351.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(si5351_emul, CONFIG_CLOCK_CONTROL_LOG_LEVEL);
+
+#define SI5351_EMUL_PLL_RESET_A BIT(5)
+#define SI5351_EMUL_PLL_RESET_B BIT(7)
+
+typedef struct
+{
+    uint32_t xtal_frequency;
+#ifdef CONFIG_GPIO_EMUL
+    // Driven as the INTR pin when the node has int-gpios on an emulated controller
+    struct gpio_dt_spec int_gpio;
+#endif
+} si5351_emul_config_t;
+
+typedef struct
+{
+    struct k_spinlock lock;
+    uint8_t regs[SI5351_REG_MAP_SIZE];
+    uint8_t pointer;
+    k_ticks_t sys_init_done;
+    k_ticks_t lock_done[2];
+    uint32_t lock_time_us;
+    int32_t xtal_error_ppb;
+    bool xtal_lost;
+    bool clkin_lost;
+    si5351_emul_stats_t stats;
+} si5351_emul_data_t;
+
+static uint8_t si5351_emul_status(si5351_emul_data_t *data)
+{
+    k_ticks_t now = k_uptime_ticks();
+    uint8_t status = 0;
+
+    if (now < data->sys_init_done)
+    {
+        // The PLLs are not running before the device has loaded its configuration
+        status |= SI5351_STATUS_SYS_INIT | SI5351_STATUS_LOL_A | SI5351_STATUS_LOL_B;
+    }
+    if (now < data->lock_done[0])
+    {
+        status |= SI5351_STATUS_LOL_A;
+    }
+    if (now < data->lock_done[1])
+    {
+        status |= SI5351_STATUS_LOL_B;
+    }
+    if (data->xtal_lost)
+    {
+        status |= SI5351_STATUS_LOS_XTAL;
+    }
+    if (data->clkin_lost)
+    {
+        status |= SI5351_STATUS_LOS_CLKIN;
+    }
+
+    // Sticky bits latch every event until cleared by the host
+    data->regs[SI5351_REG_INTERRUPT_ADR] |= status;
+    return status;
+}
+
+static uint8_t si5351_emul_read(si5351_emul_data_t *data, uint8_t reg)
+{
+    switch (reg)
+    {
+    case SI5351_REG_STATUS_ADR:
+        return si5351_emul_status(data);
+    case SI5351_REG_INTERRUPT_ADR:
+        si5351_emul_status(data);
+        return data->regs[reg];
+    default:
+        return data->regs[reg];
+    }
+}
+
+static void si5351_emul_write(si5351_emul_data_t *data, uint8_t reg, uint8_t value)
+{
+    k_ticks_t lock_done = k_uptime_ticks() + k_us_to_ticks_ceil64(data->lock_time_us);
+
+    switch (reg)
+    {
+    case SI5351_REG_STATUS_ADR:
+        // Read only
+        break;
+    case SI5351_REG_INTERRUPT_ADR:
+        // Sticky bits are cleared by writing 0
+        data->regs[reg] &= value;
+        break;
+    case SI5351_REG_PLL_RESET_ADR:
+        // Self clearing, the PLL loses lock for the configured time
+        if (value & SI5351_EMUL_PLL_RESET_A)
+        {
+            data->lock_done[0] = MAX(data->lock_done[0], lock_done);
+        }
+        if (value & SI5351_EMUL_PLL_RESET_B)
+        {
+            data->lock_done[1] = MAX(data->lock_done[1], lock_done);
+        }
+        break;
+    default:
+        data->regs[reg] = value;
+        break;
+    }
+}
+
+// INTR is asserted while any unmasked sticky bit is set
+static void si5351_emul_update_intr(const struct emul *target)
+{
+#ifdef CONFIG_GPIO_EMUL
+    si5351_emul_config_t const *cfg = target->cfg;
+    si5351_emul_data_t *data = target->data;
+
+    if (cfg->int_gpio.port == NULL)
+    {
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    si5351_emul_status(data);
+    bool asserted = (data->regs[SI5351_REG_INTERRUPT_ADR] & ~data->regs[SI5351_REG_INTERRUPT_MASK_ADR] &
+                     SI5351_INTERRUPT_MASK_ALL) != 0;
+    k_spin_unlock(&data->lock, key);
+
+    // Physical level, the pin callbacks of the driver may run from here
+    bool active_low = (cfg->int_gpio.dt_flags & GPIO_ACTIVE_LOW) != 0;
+    gpio_emul_input_set(cfg->int_gpio.port, cfg->int_gpio.pin, asserted != active_low);
+#else
+    ARG_UNUSED(target);
+#endif
+}
+
+static int si5351_emul_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs, int addr)
+{
+    si5351_emul_data_t *data = target->data;
+    si5351_emul_stats_t stats = {.transactions = 1};
+    bool reading = false;
+    bool pointer_pending = false;
+    int ret = 0;
+
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+    for (int i = 0; i < num_msgs && ret == 0; i++)
+    {
+        bool read = (msgs[i].flags & I2C_MSG_READ) != 0;
+
+        // A (repeated) start with the address byte, consecutive writes continue on the wire
+        if (i == 0 || (msgs[i].flags & I2C_MSG_RESTART) || read != reading)
+        {
+            stats.bits += 1 + 9;
+            pointer_pending = !read;
+        }
+        reading = read;
+
+        for (uint32_t j = 0; j < msgs[i].len; j++)
+        {
+            stats.bits += 9;
+
+            if (read)
+            {
+                if (data->pointer >= SI5351_REG_MAP_SIZE)
+                {
+                    ret = -EIO;
+                    break;
+                }
+                msgs[i].buf[j] = si5351_emul_read(data, data->pointer++);
+                stats.bytes_read++;
+                continue;
+            }
+
+            stats.bytes_written++;
+            if (pointer_pending)
+            {
+                data->pointer = msgs[i].buf[j];
+                pointer_pending = false;
+            }
+            else if (data->pointer >= SI5351_REG_MAP_SIZE)
+            {
+                // Data bytes beyond the register map are not acknowledged
+                ret = -EIO;
+                break;
+            }
+            else
+            {
+                si5351_emul_write(data, data->pointer++, msgs[i].buf[j]);
+            }
+        }
+    }
+    stats.bits += 1;
+
+    data->stats.transactions += stats.transactions;
+    data->stats.bytes_written += stats.bytes_written;
+    data->stats.bytes_read += stats.bytes_read;
+    data->stats.bits += stats.bits;
+
+    k_spin_unlock(&data->lock, key);
+
+    si5351_emul_update_intr(target);
+
+    if (ret)
+    {
+        LOG_ERR("Access beyond the register map at 0x%02x", data->pointer);
+    }
+    return ret;
+}
+
+void si5351_emul_get_stats(const struct emul *target, si5351_emul_stats_t *stats)
+{
+    si5351_emul_data_t *data = target->data;
+
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    *stats = data->stats;
+    k_spin_unlock(&data->lock, key);
+}
+
+void si5351_emul_reset_stats(const struct emul *target)
+{
+    si5351_emul_data_t *data = target->data;
+
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    memset(&data->stats, 0, sizeof(data->stats));
+    k_spin_unlock(&data->lock, key);
+}
+
+int si5351_emul_get_reg(const struct emul *target, uint8_t reg, uint8_t *value)
+{
+    si5351_emul_data_t *data = target->data;
+
+    if (reg >= SI5351_REG_MAP_SIZE)
+    {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    *value = si5351_emul_read(data, reg);
+    k_spin_unlock(&data->lock, key);
+
+    return 0;
+}
+
+int si5351_emul_set_reg(const struct emul *target, uint8_t reg, uint8_t value)
+{
+    si5351_emul_data_t *data = target->data;
+
+    if (reg >= SI5351_REG_MAP_SIZE)
+    {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    si5351_emul_write(data, reg, value);
+    k_spin_unlock(&data->lock, key);
+
+    return 0;
+}
+
+void si5351_emul_power_up(const struct emul *target)
+{
+    si5351_emul_data_t *data = target->data;
+
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+    memset(data->regs, 0, sizeof(data->regs));
+    // Outputs come up powered down and disabled
+    memset(&data->regs[SI5351_REG_CLK_OUT_CTRL_ADR_BASE], 0x80, 8 * SI5351_REG_CLK_OUT_CTRL_SIZE);
+    data->regs[SI5351_REG_OEB_ADR] = 0xff;
+    data->pointer = 0;
+
+    data->sys_init_done = k_uptime_ticks() + k_ms_to_ticks_ceil64(CONFIG_EMUL_SI5351_SYS_INIT_TIME_MS);
+    data->lock_done[0] = data->sys_init_done;
+    data->lock_done[1] = data->sys_init_done;
+
+    k_spin_unlock(&data->lock, key);
+
+    si5351_emul_update_intr(target);
+}
+
+void si5351_emul_set_lock_time(const struct emul *target, uint32_t lock_time_us)
+{
+    si5351_emul_data_t *data = target->data;
+
+    data->lock_time_us = lock_time_us;
+}
+
+void si5351_emul_set_loss_of_signal(const struct emul *target, bool xtal, bool clkin)
+{
+    si5351_emul_data_t *data = target->data;
+
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    data->xtal_lost = xtal;
+    data->clkin_lost = clkin;
+    k_spin_unlock(&data->lock, key);
+
+    si5351_emul_update_intr(target);
+}
+
+void si5351_emul_set_xtal_error(const struct emul *target, int32_t ppb)
+{
+    si5351_emul_data_t *data = target->data;
+
+    data->xtal_error_ppb = ppb;
+}
+
+static void si5351_emul_decode(uint8_t const *buffer, uint32_t *p1, uint32_t *p2, uint32_t *p3)
+{
+    *p1 = (buffer[2] & 0x03) << 16 | buffer[3] << 8 | buffer[4];
+    *p2 = (buffer[5] & 0x0f) << 16 | buffer[6] << 8 | buffer[7];
+    *p3 = (buffer[5] & 0xf0) << 12 | buffer[0] << 8 | buffer[1];
+}
+
+int si5351_emul_get_output_frequency(const struct emul *target, uint8_t output_index, uint64_t *frequency)
+{
+    si5351_emul_config_t const *cfg = target->cfg;
+    si5351_emul_data_t *data = target->data;
+    uint8_t regs[SI5351_REG_MAP_SIZE];
+
+    if (output_index >= 8)
+    {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    memcpy(regs, data->regs, sizeof(regs));
+    k_spin_unlock(&data->lock, key);
+
+    uint8_t clk_ctrl = regs[SI5351_REG_CLK_OUT_CTRL_ADR_BASE + output_index];
+    if ((clk_ctrl & BIT(7)) || (regs[SI5351_REG_OEB_ADR] & BIT(output_index)))
+    {
+        *frequency = 0;
+        return 0;
+    }
+
+    uint64_t xtal = (uint64_t)cfg->xtal_frequency * SI5351_MILLIHZ_PER_HZ;
+    xtal += (int64_t)xtal * data->xtal_error_ppb / 1000000000;
+    uint8_t ms_index = output_index;
+    uint8_t r;
+    uint64_t f;
+
+    switch ((clk_ctrl >> 2) & 0x03)
+    {
+    case 0:
+        f = xtal;
+        break;
+    case 1:
+        return -ENOTSUP;
+    case 2:
+        // CLK1-3 and CLK5-7 may share the multisynth of CLK0 or CLK4
+        ms_index = output_index & 0x04;
+        __fallthrough;
+    default:
+    {
+        uint8_t pll_ctrl = regs[SI5351_REG_CLK_OUT_CTRL_ADR_BASE + ms_index];
+        bool pllb = (pll_ctrl & BIT(5)) != 0;
+        if (regs[SI5351_REG_PLL_CFG_ADR] & (pllb ? BIT(3) : BIT(2)))
+        {
+            return -ENOTSUP;
+        }
+
+        uint32_t p1, p2, p3;
+        si5351_emul_decode(&regs[SI5351_REG_PLL_X_ADR_BASE + (pllb ? SI5351_REG_PLL_X_SIZE : 0)], &p1, &p2, &p3);
+        if (p3 == 0)
+        {
+            *frequency = 0;
+            return 0;
+        }
+        // The products reach 1e20 for a fractional multisynth, far beyond 64 bits
+        f = si5351_mul_div_round(xtal, (uint64_t)p3 * (p1 + 512) + p2, 128 * (uint64_t)p3);
+
+        if (ms_index >= SI5351_INTEGER_OUTPUT_FIRST)
+        {
+            uint8_t ratio = regs[SI5351_REG_CLK_OUT_INT_X_ADR_BASE + ms_index - SI5351_INTEGER_OUTPUT_FIRST];
+            f = ratio == 0 ? 0 : f / ratio;
+        }
+        else
+        {
+            uint8_t const *ms = &regs[SI5351_REG_CLK_OUT_X_ADR_BASE + ms_index * SI5351_REG_CLK_OUT_X_SIZE];
+            if (((ms[2] >> 2) & 0x03) == 0x03)
+            {
+                f /= 4;
+            }
+            else
+            {
+                si5351_emul_decode(ms, &p1, &p2, &p3);
+                uint64_t den = (uint64_t)p3 * (p1 + 512) + p2;
+                f = p3 == 0 ? 0 : si5351_mul_div_round(f, 128 * (uint64_t)p3, den);
+            }
+        }
+        break;
+    }
+    }
+
+    if (output_index >= SI5351_INTEGER_OUTPUT_FIRST)
+    {
+        r = (regs[SI5351_REG_CLK_OUT_INT_R_ADR] >> SI5351_REG_CLK_OUT_INT_R_SHIFT(output_index)) & 0x07;
+    }
+    else
+    {
+        r = (regs[SI5351_REG_CLK_OUT_X_ADR_BASE + output_index * SI5351_REG_CLK_OUT_X_SIZE + 2] >> 4) & 0x07;
+    }
+
+    *frequency = f >> r;
+    return 0;
+}
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_DISCIPLINE
+int si5351_emul_discipline_measure(const struct device *output, int32_t *error_ppb, void *user_data)
+{
+    si5351_emul_discipline_source_t const *source = user_data;
+    uint64_t frequency;
+
+    int ret = si5351_emul_get_output_frequency(source->emul, source->output_index, &frequency);
+    if (ret)
+    {
+        return ret;
+    }
+    if (frequency == 0 || source->frequency == 0)
+    {
+        return -EAGAIN;
+    }
+
+    bool fast = frequency > source->frequency;
+    uint64_t error = si5351_mul_div_round(fast ? frequency - source->frequency : source->frequency - frequency,
+                                          SI5351_PPB, source->frequency);
+    error = MIN(error, INT32_MAX);
+    *error_ppb = fast ? (int32_t)error : -(int32_t)error;
+    return 0;
+}
+#endif
+
+static int si5351_emul_init(const struct emul *target, const struct device *parent)
+{
+    si5351_emul_data_t *data = target->data;
+
+    data->lock_time_us = CONFIG_EMUL_SI5351_LOCK_TIME_US;
+    si5351_emul_power_up(target);
+
+    return 0;
+}
+
+static const struct i2c_emul_api si5351_emul_api = {
+    .transfer = si5351_emul_transfer,
+};
+
+#ifdef CONFIG_GPIO_EMUL
+#define SI5351_EMUL_INT_GPIO(inst) .int_gpio = GPIO_DT_SPEC_INST_GET_OR(inst, int_gpios, {0}),
+#else
+#define SI5351_EMUL_INT_GPIO(inst)
+#endif
+
+#define SI5351_EMUL(inst)                                                    \
+    static si5351_emul_data_t si5351_emul_data_##inst;                       \
+    static const si5351_emul_config_t si5351_emul_config_##inst = {          \
+        .xtal_frequency = DT_INST_PROP(inst, xtal_frequency),                \
+        SI5351_EMUL_INT_GPIO(inst)                                           \
+    };                                                                       \
+    EMUL_DT_INST_DEFINE(inst, si5351_emul_init, &si5351_emul_data_##inst,    \
+                        &si5351_emul_config_##inst, &si5351_emul_api, NULL)
+
+DT_INST_FOREACH_STATUS_OKAY(SI5351_EMUL)
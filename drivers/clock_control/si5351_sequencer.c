@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2025 Jonatan Gezelius
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Timed sweep / hop sequencer. All steps are encoded before the sequence starts so the
+// sequencer thread only writes pre-encoded PLL bytes, step start times are taken from
+// absolute deadlines so scheduling delays do not add up over a sequence.
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/clock_control/si5351.h>
+
+#include "si5351.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(clock_control_si5351, CONFIG_CLOCK_CONTROL_LOG_LEVEL);
+
+static K_SEM_DEFINE(si5351_sequencer_start_sem, 0, 1);
+static K_SEM_DEFINE(si5351_sequencer_stop_sem, 0, 1);
+
+static struct k_spinlock si5351_sequencer_lock;
+static si5351_sequencer_t *si5351_sequencer_active;
+
+static int si5351_sequencer_run(si5351_sequencer_t *sequencer)
+{
+    k_ticks_t deadline = k_uptime_ticks();
+
+    do
+    {
+        for (size_t i = 0; i < sequencer->num_steps; i++)
+        {
+            si5351_sequence_step_t const *step = &sequencer->steps[i];
+
+            k_ticks_t lateness = k_uptime_ticks() - deadline;
+            uint32_t lateness_us = k_ticks_to_us_ceil32(lateness > 0 ? lateness : 0);
+            if (lateness_us > sequencer->max_lateness_us)
+            {
+                sequencer->max_lateness_us = lateness_us;
+            }
+
+            int ret = si5351_output_hop(sequencer->output, &step->hop);
+            if (ret)
+            {
+                return ret;
+            }
+
+            // Stop requests wake the thread early, otherwise it sleeps out the dwell
+            deadline += k_us_to_ticks_ceil64(step->dwell_us);
+            if (k_sem_take(&si5351_sequencer_stop_sem, K_TIMEOUT_ABS_TICKS(deadline)) == 0)
+            {
+                return -ECANCELED;
+            }
+        }
+
+        sequencer->iterations++;
+    } while (sequencer->loop);
+
+    return 0;
+}
+
+static void si5351_sequencer_thread(void *p1, void *p2, void *p3)
+{
+    while (true)
+    {
+        k_sem_take(&si5351_sequencer_start_sem, K_FOREVER);
+
+        k_spinlock_key_t key = k_spin_lock(&si5351_sequencer_lock);
+        si5351_sequencer_t *sequencer = si5351_sequencer_active;
+        k_spin_unlock(&si5351_sequencer_lock, key);
+
+        int result = si5351_sequencer_run(sequencer);
+
+        // Released before the callback so it may start the next sequence
+        key = k_spin_lock(&si5351_sequencer_lock);
+        si5351_sequencer_active = NULL;
+        k_spin_unlock(&si5351_sequencer_lock, key);
+
+        if (sequencer->callback != NULL)
+        {
+            sequencer->callback(sequencer->output, result, sequencer->user_data);
+        }
+    }
+}
+
+K_THREAD_DEFINE(si5351_sequencer_thread_id, CONFIG_CLOCK_CONTROL_SI5351_SEQUENCER_STACK_SIZE,
+                si5351_sequencer_thread, NULL, NULL, NULL,
+                CONFIG_CLOCK_CONTROL_SI5351_SEQUENCER_PRIORITY, 0, 0);
+
+int si5351_sequencer_start(si5351_sequencer_t *sequencer)
+{
+    if (sequencer->output == NULL || sequencer->steps == NULL || sequencer->num_steps == 0)
+    {
+        return -EINVAL;
+    }
+
+    // Encoding happens here, in the caller's context, never between steps
+    for (size_t i = 0; i < sequencer->num_steps; i++)
+    {
+        si5351_sequence_step_t *step = &sequencer->steps[i];
+
+        if (step->frequency == 0)
+        {
+            continue;
+        }
+
+        int ret = si5351_output_encode_hop_table(sequencer->output, &step->frequency, &step->hop, 1);
+        if (ret)
+        {
+            return ret;
+        }
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&si5351_sequencer_lock);
+    if (si5351_sequencer_active != NULL)
+    {
+        k_spin_unlock(&si5351_sequencer_lock, key);
+        return -EBUSY;
+    }
+    si5351_sequencer_active = sequencer;
+    sequencer->iterations = 0;
+    sequencer->max_lateness_us = 0;
+    k_sem_reset(&si5351_sequencer_stop_sem);
+    k_spin_unlock(&si5351_sequencer_lock, key);
+
+    k_sem_give(&si5351_sequencer_start_sem);
+    return 0;
+}
+
+int si5351_sequencer_stop(si5351_sequencer_t *sequencer)
+{
+    k_spinlock_key_t key = k_spin_lock(&si5351_sequencer_lock);
+    bool running = si5351_sequencer_active == sequencer;
+    k_spin_unlock(&si5351_sequencer_lock, key);
+
+    if (!running)
+    {
+        return -EALREADY;
+    }
+
+    // Completion is reported through the callback with -ECANCELED
+    k_sem_give(&si5351_sequencer_stop_sem);
+    return 0;
+}
+
+void si5351_sequencer_set_loop(si5351_sequencer_t *sequencer, bool loop)
+{
+    sequencer->loop = loop;
+}
@@ -0,0 +1,684 @@
+/*
+ * Copyright (c) 2025 Jonatan Gezelius
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// si5351 shell commands for live tuning and bus cost measurements
+
+#define DT_DRV_COMPAT skyworks_si5351
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/clock_control/si5351.h>
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "si5351.h"
+
+#define SI5351_SHELL_DUMP_LINE 16
+
+typedef struct
+{
+    const struct device *chip;
+    const struct device *output;
+    uint8_t index;
+} si5351_shell_output_t;
+
+#define SI5351_SHELL_CHIP(inst) DEVICE_DT_INST_GET(inst),
+#define SI5351_SHELL_OUTPUT(node_id) \
+    {DEVICE_DT_GET(DT_PARENT(node_id)), DEVICE_DT_GET(node_id), DT_REG_ADDR(node_id)},
+
+static const struct device *const si5351_shell_chips[] = {DT_INST_FOREACH_STATUS_OKAY(SI5351_SHELL_CHIP)};
+static const si5351_shell_output_t si5351_shell_outputs[] = {
+    DT_FOREACH_STATUS_OKAY(skyworks_si5351_output, SI5351_SHELL_OUTPUT)};
+
+static const struct device *si5351_shell_get_chip(const struct shell *sh, const char *name)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(si5351_shell_chips); i++)
+    {
+        if (strcmp(si5351_shell_chips[i]->name, name) == 0)
+        {
+            if (!device_is_ready(si5351_shell_chips[i]))
+            {
+                shell_error(sh, "%s is not ready", name);
+                return NULL;
+            }
+            return si5351_shell_chips[i];
+        }
+    }
+
+    shell_error(sh, "No si5351 named %s, see 'si5351 list'", name);
+    return NULL;
+}
+
+static const struct device *si5351_shell_get_output(const struct shell *sh, const struct device *chip, const char *index)
+{
+    int err = 0;
+    unsigned long output_index = shell_strtoul(index, 0, &err);
+
+    for (size_t i = 0; err == 0 && i < ARRAY_SIZE(si5351_shell_outputs); i++)
+    {
+        if (si5351_shell_outputs[i].chip == chip && si5351_shell_outputs[i].index == output_index)
+        {
+            return si5351_shell_outputs[i].output;
+        }
+    }
+
+    shell_error(sh, "Output %s is not enabled on %s", index, chip->name);
+    return NULL;
+}
+
+static int si5351_shell_get_pll(const struct shell *sh, const char *name, si5351_pll_mask_t *pll)
+{
+    if (strcmp(name, "a") == 0)
+    {
+        *pll = si5351_pll_mask_a;
+    }
+    else if (strcmp(name, "b") == 0)
+    {
+        *pll = si5351_pll_mask_b;
+    }
+    else if (strcmp(name, "ab") == 0)
+    {
+        *pll = si5351_pll_mask_a | si5351_pll_mask_b;
+    }
+    else
+    {
+        shell_error(sh, "PLL must be a, b or ab");
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
+// Hz with up to three decimals to milli-Hz
+static int si5351_shell_parse_frequency(const char *str, uint64_t *frequency)
+{
+    char integer[21];
+    const char *dot = strchr(str, '.');
+    size_t integer_length = dot != NULL ? (size_t)(dot - str) : strlen(str);
+    int err = 0;
+
+    if (integer_length == 0 || integer_length >= sizeof(integer))
+    {
+        return -EINVAL;
+    }
+    memcpy(integer, str, integer_length);
+    integer[integer_length] = '\0';
+
+    *frequency = shell_strtoull(integer, 10, &err) * SI5351_MILLIHZ_PER_HZ;
+    if (err)
+    {
+        return err;
+    }
+
+    if (dot != NULL)
+    {
+        uint32_t scale = SI5351_MILLIHZ_PER_HZ / 10;
+        for (const char *c = dot + 1; *c != '\0'; c++, scale /= 10)
+        {
+            if (*c < '0' || *c > '9' || scale == 0)
+            {
+                return -EINVAL;
+            }
+            *frequency += (*c - '0') * scale;
+        }
+    }
+
+    return 0;
+}
+
+static void si5351_shell_print_frequency(const struct shell *sh, const char *label, uint64_t frequency)
+{
+    shell_print(sh, "%s%" PRIu64 ".%03u Hz", label, (uint64_t)(frequency / SI5351_MILLIHZ_PER_HZ),
+                (unsigned int)(frequency % SI5351_MILLIHZ_PER_HZ));
+}
+
+static int cmd_si5351_list(const struct shell *sh, size_t argc, char **argv)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(si5351_shell_chips); i++)
+    {
+        shell_print(sh, "%s", si5351_shell_chips[i]->name);
+        for (size_t j = 0; j < ARRAY_SIZE(si5351_shell_outputs); j++)
+        {
+            if (si5351_shell_outputs[j].chip == si5351_shell_chips[i])
+            {
+                shell_print(sh, "  %u: %s", si5351_shell_outputs[j].index, si5351_shell_outputs[j].output->name);
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int cmd_si5351_status(const struct shell *sh, size_t argc, char **argv)
+{
+    const struct device *chip = si5351_shell_get_chip(sh, argv[1]);
+    si5351_status_t status;
+
+    if (chip == NULL)
+    {
+        return -ENODEV;
+    }
+
+    int ret = si5351_get_status(chip, &status);
+    if (ret)
+    {
+        shell_error(sh, "Could not read status (%d)", ret);
+        return ret;
+    }
+
+    shell_print(sh, "SYS_INIT:  %s", status.sys_init ? "busy" : "done");
+    shell_print(sh, "PLLA:      %s", status.plla_loss_of_lock ? "unlocked" : "locked");
+    shell_print(sh, "PLLB:      %s", status.pllb_loss_of_lock ? "unlocked" : "locked");
+    shell_print(sh, "CLKIN:     %s", status.clkin_loss_of_signal ? "lost" : "ok");
+    shell_print(sh, "XTAL:      %s", status.xtal_loss_of_signal ? "lost" : "ok");
+    shell_print(sh, "Revision:  %u", status.revision_id);
+
+    return 0;
+}
+
+static int cmd_si5351_freq(const struct shell *sh, size_t argc, char **argv)
+{
+    const struct device *chip = si5351_shell_get_chip(sh, argv[1]);
+    const struct device *output = chip != NULL ? si5351_shell_get_output(sh, chip, argv[2]) : NULL;
+    uint64_t frequency;
+    int ret;
+
+    if (output == NULL)
+    {
+        return -ENODEV;
+    }
+
+    if (argc > 3)
+    {
+        if (si5351_shell_parse_frequency(argv[3], &frequency))
+        {
+            shell_error(sh, "Invalid frequency %s", argv[3]);
+            return -EINVAL;
+        }
+
+        ret = si5351_output_set_frequency(output, frequency);
+        if (ret)
+        {
+            shell_error(sh, "Could not set frequency (%d)", ret);
+            return ret;
+        }
+    }
+
+    ret = si5351_output_get_frequency(output, &frequency);
+    if (ret)
+    {
+        shell_error(sh, "Could not get frequency (%d)", ret);
+        return ret;
+    }
+
+    si5351_shell_print_frequency(sh, "", frequency);
+    return 0;
+}
+
+static int si5351_shell_set_field(si5351_output_parameters_t *parameters, const char *field, unsigned long value)
+{
+    if (strcmp(field, "enabled") == 0)
+    {
+        parameters->output_enabled = value ? si5351_output_output_enabled : si5351_output_output_disabled;
+    }
+    else if (strcmp(field, "powered") == 0)
+    {
+        parameters->powered_up = value ? si5351_output_powered_up : si5351_output_powered_down;
+    }
+    else if (strcmp(field, "integer") == 0)
+    {
+        parameters->integer_mode = value ? si5351_output_integer_mode_enabled : si5351_output_integer_mode_disabled;
+    }
+    else if (strcmp(field, "pllb") == 0)
+    {
+        parameters->multisynth_source = value ? si5351_output_multisynth_source_pllb : si5351_output_multisynth_source_plla;
+    }
+    else if (strcmp(field, "invert") == 0)
+    {
+        parameters->invert = value ? si5351_output_invert_enabled : si5351_output_invert_disabled;
+    }
+    else if (strcmp(field, "source") == 0 && (value <= si5351_output_clk_source_clkin || value == si5351_output_clk_source_multisynth))
+    {
+        parameters->clock_source = value;
+    }
+    else if (strcmp(field, "drive") == 0 && value <= si5351_output_drive_strength_8ma)
+    {
+        parameters->drive_strength = value;
+    }
+    else if (strcmp(field, "p1") == 0 && value < BIT(18))
+    {
+        parameters->p1 = value;
+    }
+    else if (strcmp(field, "p2") == 0 && value < BIT(20))
+    {
+        parameters->p2 = value;
+    }
+    else if (strcmp(field, "p3") == 0 && value < BIT(20))
+    {
+        parameters->p3 = value;
+    }
+    else if (strcmp(field, "r") == 0 && value <= si5351_output_r_128)
+    {
+        parameters->r = value;
+    }
+    else if (strcmp(field, "div4") == 0)
+    {
+        parameters->divide_by_four = value != 0;
+    }
+    else if (strcmp(field, "phase") == 0 && value < BIT(7))
+    {
+        parameters->phase_offset = value;
+    }
+    else
+    {
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
+static int cmd_si5351_param(const struct shell *sh, size_t argc, char **argv)
+{
+    const struct device *chip = si5351_shell_get_chip(sh, argv[1]);
+    const struct device *output = chip != NULL ? si5351_shell_get_output(sh, chip, argv[2]) : NULL;
+    si5351_output_parameters_t parameters;
+    int ret;
+
+    if (output == NULL)
+    {
+        return -ENODEV;
+    }
+
+    ret = si5351_output_get_parameters(output, si5351_parameter_source_cache, &parameters);
+    if (ret)
+    {
+        return ret;
+    }
+
+    if (argc == 4)
+    {
+        shell_error(sh, "Missing value for %s", argv[3]);
+        return -EINVAL;
+    }
+
+    if (argc > 4)
+    {
+        int err = 0;
+        unsigned long value = shell_strtoul(argv[4], 0, &err);
+
+        if (err || si5351_shell_set_field(&parameters, argv[3], value))
+        {
+            shell_error(sh, "Invalid field or value %s %s", argv[3], argv[4]);
+            return -EINVAL;
+        }
+
+        ret = si5351_output_set_parameters(output, &parameters);
+        if (ret)
+        {
+            shell_error(sh, "Could not set parameters (%d)", ret);
+            return ret;
+        }
+    }
+
+    shell_print(sh, "enabled %u powered %u integer %u pllb %u invert %u source %u drive %u",
+                parameters.output_enabled == si5351_output_output_enabled,
+                parameters.powered_up == si5351_output_powered_up,
+                parameters.integer_mode, parameters.multisynth_source, parameters.invert,
+                parameters.clock_source, parameters.drive_strength);
+    shell_print(sh, "p1 %u p2 %u p3 %u r %u div4 %u phase %u",
+                parameters.p1, parameters.p2, parameters.p3, parameters.r,
+                parameters.divide_by_four, parameters.phase_offset);
+
+    return 0;
+}
+
+static int cmd_si5351_pll(const struct shell *sh, size_t argc, char **argv)
+{
+    const struct device *chip = si5351_shell_get_chip(sh, argv[1]);
+    si5351_parameters_t parameters;
+    si5351_pll_mask_t pll_mask;
+
+    if (chip == NULL)
+    {
+        return -ENODEV;
+    }
+    if (si5351_shell_get_pll(sh, argv[2], &pll_mask) || pll_mask == (si5351_pll_mask_a | si5351_pll_mask_b))
+    {
+        return -EINVAL;
+    }
+
+    int ret = si5351_get_parameters(chip, si5351_parameter_source_cache, &parameters);
+    if (ret)
+    {
+        return ret;
+    }
+    si5351_pll_parameters_t *pll = pll_mask == si5351_pll_mask_a ? &parameters.plla : &parameters.pllb;
+
+    if (argc > 3)
+    {
+        int err = 0;
+
+        if (argc != 6)
+        {
+            shell_error(sh, "Expected p1 p2 p3");
+            return -EINVAL;
+        }
+
+        pll->p1 = shell_strtoul(argv[3], 0, &err);
+        pll->p2 = shell_strtoul(argv[4], 0, &err);
+        pll->p3 = shell_strtoul(argv[5], 0, &err);
+        if (err)
+        {
+            shell_error(sh, "Invalid parameters");
+            return -EINVAL;
+        }
+
+        // The PLL is not reset, use 'si5351 reset' once all changes are in
+        ret = si5351_tune_pll(chip, pll_mask, pll);
+        if (ret)
+        {
+            shell_error(sh, "Could not tune PLL (%d)", ret);
+            return ret;
+        }
+    }
+
+    shell_print(sh, "%s p1 %u p2 %u p3 %u", pll->clock_source == si5351_pll_clock_source_xtal ? "XTAL" : "CLKIN",
+                pll->p1, pll->p2, pll->p3);
+    return 0;
+}
+
+static int cmd_si5351_xtal(const struct shell *sh, size_t argc, char **argv)
+{
+    const struct device *chip = si5351_shell_get_chip(sh, argv[1]);
+    uint64_t frequency;
+    int32_t ppb;
+    int ret;
+
+    if (chip == NULL)
+    {
+        return -ENODEV;
+    }
+
+    if (argc > 2)
+    {
+        int err = 0;
+
+        ppb = shell_strtol(argv[2], 10, &err);
+        if (err)
+        {
+            shell_error(sh, "Invalid correction %s", argv[2]);
+            return -EINVAL;
+        }
+
+        ret = si5351_set_xtal_correction(chip, ppb);
+        if (ret)
+        {
+            shell_error(sh, "Could not set correction (%d)", ret);
+            return ret;
+        }
+    }
+
+    si5351_get_xtal_frequency(chip, &frequency, &ppb);
+    si5351_shell_print_frequency(sh, "", frequency);
+    shell_print(sh, "correction %d ppb", (int)ppb);
+    return 0;
+}
+
+static int cmd_si5351_plan(const struct shell *sh, size_t argc, char **argv)
+{
+    const struct device *chip = si5351_shell_get_chip(sh, argv[1]);
+    si5351_output_request_t requests[SI5351_FREQUENCY_PLAN_OUTPUTS_MAX];
+    si5351_frequency_plan_t plan;
+    bool apply = strcmp(argv[argc - 1], "apply") == 0;
+    size_t num_requests = (argc - 2 - apply) / 2;
+
+    if (chip == NULL)
+    {
+        return -ENODEV;
+    }
+    if ((argc - 2 - apply) % 2 != 0)
+    {
+        shell_error(sh, "Expected output and frequency pairs");
+        return -EINVAL;
+    }
+
+    for (size_t i = 0; i < num_requests; i++)
+    {
+        requests[i].output = si5351_shell_get_output(sh, chip, argv[2 + 2 * i]);
+        if (requests[i].output == NULL)
+        {
+            return -ENODEV;
+        }
+        if (si5351_shell_parse_frequency(argv[3 + 2 * i], &requests[i].frequency))
+        {
+            shell_error(sh, "Invalid frequency %s", argv[3 + 2 * i]);
+            return -EINVAL;
+        }
+    }
+
+    int ret = si5351_plan_frequencies(chip, requests, num_requests, &plan);
+    if (ret)
+    {
+        shell_error(sh, "No plan for these frequencies (%d)", ret);
+        return ret;
+    }
+
+    shell_print(sh, "PLLA p1 %u p2 %u p3 %u%s", plan.plla.p1, plan.plla.p2, plan.plla.p3,
+                (plan.pll_reset & si5351_pll_mask_a) ? " (retuned)" : "");
+    shell_print(sh, "PLLB p1 %u p2 %u p3 %u%s", plan.pllb.p1, plan.pllb.p2, plan.pllb.p3,
+                (plan.pll_reset & si5351_pll_mask_b) ? " (retuned)" : "");
+    for (size_t i = 0; i < plan.num_outputs; i++)
+    {
+        si5351_output_parameters_t const *parameters = &plan.parameters[i];
+
+        shell_print(sh, "%s: PLL%c p1 %u p2 %u p3 %u r %u%s", plan.outputs[i]->name,
+                    parameters->multisynth_source == si5351_output_multisynth_source_pllb ? 'B' : 'A',
+                    parameters->p1, parameters->p2, parameters->p3, 1U << parameters->r,
+                    parameters->integer_mode == si5351_output_integer_mode_enabled ? " integer" : "");
+    }
+    shell_print(sh, "%u output(s) without an even integer multisynth", plan.num_fractional);
+
+    if (apply)
+    {
+        ret = si5351_apply_frequency_plan(chip, &plan);
+        if (ret)
+        {
+            shell_error(sh, "Could not apply plan (%d)", ret);
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+static int cmd_si5351_reset(const struct shell *sh, size_t argc, char **argv)
+{
+    const struct device *chip = si5351_shell_get_chip(sh, argv[1]);
+    si5351_pll_mask_t pll_mask;
+
+    if (chip == NULL)
+    {
+        return -ENODEV;
+    }
+    if (si5351_shell_get_pll(sh, argv[2], &pll_mask))
+    {
+        return -EINVAL;
+    }
+
+    int ret = si5351_reset_pll(chip, pll_mask);
+    if (ret)
+    {
+        shell_error(sh, "PLL reset failed (%d)", ret);
+    }
+    return ret;
+}
+
+static int cmd_si5351_dump(const struct shell *sh, size_t argc, char **argv)
+{
+    const struct device *chip = si5351_shell_get_chip(sh, argv[1]);
+    uint8_t registers[SI5351_REG_MAP_SIZE];
+    unsigned long first = 0;
+    unsigned long count = SI5351_REG_MAP_SIZE;
+    int err = 0;
+
+    if (chip == NULL)
+    {
+        return -ENODEV;
+    }
+
+    if (argc > 2)
+    {
+        first = shell_strtoul(argv[2], 0, &err);
+        count = argc > 3 ? shell_strtoul(argv[3], 0, &err) : 1;
+    }
+    if (err || first >= SI5351_REG_MAP_SIZE || count == 0 || first + count > SI5351_REG_MAP_SIZE)
+    {
+        shell_error(sh, "Registers must be within 0x00-0x%02x", SI5351_REG_MAP_SIZE - 1);
+        return -EINVAL;
+    }
+
+    // One burst for the whole range
+    int ret = si5351_register_read(chip, first, registers, count);
+    if (ret)
+    {
+        shell_error(sh, "Could not read registers (%d)", ret);
+        return ret;
+    }
+
+    shell_hexdump_line(sh, first, registers, MIN(count, SI5351_SHELL_DUMP_LINE));
+    for (unsigned long offset = SI5351_SHELL_DUMP_LINE; offset < count; offset += SI5351_SHELL_DUMP_LINE)
+    {
+        shell_hexdump_line(sh, first + offset, &registers[offset], MIN(count - offset, SI5351_SHELL_DUMP_LINE));
+    }
+
+    return 0;
+}
+
+static int cmd_si5351_poke(const struct shell *sh, size_t argc, char **argv)
+{
+    const struct device *chip = si5351_shell_get_chip(sh, argv[1]);
+    int err = 0;
+
+    if (chip == NULL)
+    {
+        return -ENODEV;
+    }
+
+    unsigned long reg = shell_strtoul(argv[2], 0, &err);
+    unsigned long value = shell_strtoul(argv[3], 0, &err);
+    if (err || reg >= SI5351_REG_MAP_SIZE || value > UINT8_MAX)
+    {
+        shell_error(sh, "Invalid register or value");
+        return -EINVAL;
+    }
+
+    int ret = si5351_register_write(chip, reg, value);
+    if (ret)
+    {
+        shell_error(sh, "Could not write register (%d)", ret);
+    }
+    return ret;
+}
+
+static int cmd_si5351_bench(const struct shell *sh, size_t argc, char **argv)
+{
+    const struct device *chip = si5351_shell_get_chip(sh, argv[1]);
+    const struct device *output = chip != NULL ? si5351_shell_get_output(sh, chip, argv[2]) : NULL;
+    uint64_t step = 1000 * SI5351_MILLIHZ_PER_HZ;
+    uint64_t frequency;
+    int err = 0;
+
+    if (output == NULL)
+    {
+        return -ENODEV;
+    }
+
+    unsigned long iterations = shell_strtoul(argv[3], 0, &err);
+    if (err || iterations == 0)
+    {
+        shell_error(sh, "Invalid iteration count %s", argv[3]);
+        return -EINVAL;
+    }
+    if (argc > 4 && si5351_shell_parse_frequency(argv[4], &step))
+    {
+        shell_error(sh, "Invalid step %s", argv[4]);
+        return -EINVAL;
+    }
+
+    int ret = si5351_output_get_frequency(output, &frequency);
+    if (ret)
+    {
+        return ret;
+    }
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_STATS
+    si5351_data_t *data = chip->data;
+    uint32_t transactions = data->stats.transactions;
+    uint32_t bytes = data->stats.bytes_written + data->stats.bytes_read;
+#endif
+
+    // Alternate between the current frequency and one step above it
+    uint32_t min_us = UINT32_MAX, max_us = 0;
+    uint64_t total_us = 0;
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+        uint32_t start = k_cycle_get_32();
+        ret = si5351_output_set_frequency(output, (i & 1) ? frequency : frequency + step);
+        uint32_t latency_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+        if (ret)
+        {
+            shell_error(sh, "Retune %lu failed (%d)", i, ret);
+            break;
+        }
+
+        min_us = MIN(min_us, latency_us);
+        max_us = MAX(max_us, latency_us);
+        total_us += latency_us;
+    }
+
+    si5351_output_set_frequency(output, frequency);
+    if (ret)
+    {
+        return ret;
+    }
+
+    shell_print(sh, "%lu retunes: min %u us, avg %" PRIu64 " us, max %u us", iterations, min_us,
+                total_us / iterations, max_us);
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_STATS
+    // Per op figures with one decimal
+    uint64_t transactions_x10 = (uint64_t)(data->stats.transactions - transactions) * 10 / iterations;
+    uint64_t bytes_x10 = (uint64_t)(data->stats.bytes_written + data->stats.bytes_read - bytes) * 10 / iterations;
+    shell_print(sh, "per retune: %" PRIu64 ".%u transactions, %" PRIu64 ".%u bytes",
+                transactions_x10 / 10, (unsigned int)(transactions_x10 % 10), bytes_x10 / 10, (unsigned int)(bytes_x10 % 10));
+#else
+    shell_print(sh, "Enable CONFIG_CLOCK_CONTROL_SI5351_STATS for bus cost per retune");
+#endif
+
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+    si5351_cmds,
+    SHELL_CMD_ARG(list, NULL, "List devices and outputs", cmd_si5351_list, 1, 0),
+    SHELL_CMD_ARG(status, NULL, "<device>", cmd_si5351_status, 2, 0),
+    SHELL_CMD_ARG(freq, NULL, "<device> <output> [Hz, up to 3 decimals]", cmd_si5351_freq, 3, 1),
+    SHELL_CMD_ARG(param, NULL,
+                  "<device> <output> [<field> <value>]\n"
+                  "fields: enabled powered integer pllb invert source drive p1 p2 p3 r div4 phase",
+                  cmd_si5351_param, 3, 2),
+    SHELL_CMD_ARG(pll, NULL, "<device> <a|b> [<p1> <p2> <p3>]", cmd_si5351_pll, 3, 3),
+    SHELL_CMD_ARG(xtal, NULL, "<device> [correction ppb]", cmd_si5351_xtal, 2, 1),
+    SHELL_CMD_ARG(plan, NULL, "<device> <output> <Hz> [<output> <Hz> ...] [apply]", cmd_si5351_plan, 4,
+                  2 * SI5351_FREQUENCY_PLAN_OUTPUTS_MAX - 1),
+    SHELL_CMD_ARG(reset, NULL, "<device> <a|b|ab>", cmd_si5351_reset, 3, 0),
+    SHELL_CMD_ARG(dump, NULL, "<device> [<first> [<count>]]", cmd_si5351_dump, 2, 2),
+    SHELL_CMD_ARG(poke, NULL, "<device> <register> <value>", cmd_si5351_poke, 4, 0),
+    SHELL_CMD_ARG(bench, NULL, "<device> <output> <retunes> [step Hz, default 1000]", cmd_si5351_bench, 4, 1),
+    SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(si5351, &si5351_cmds, "Si5351 clock generator", NULL);
@@ -0,0 +1,663 @@
+/*
+ * Copyright (c) 2025 Jonatan Gezelius
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Integer only frequency planning for the si5351, see AN619 for the divider equations.
+// All frequencies are handled in milli-Hz so that fractional targets can be expressed.
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include "si5351.h"
+
+// floor((a * b + c / 2) / c) with a 128 bit intermediate product, the result must fit in 64 bits
+uint64_t si5351_mul_div_round(uint64_t a, uint64_t b, uint64_t c)
+{
+    uint64_t a_lo = (uint32_t)a;
+    uint64_t a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b;
+    uint64_t b_hi = b >> 32;
+
+    uint64_t ll = a_lo * b_lo;
+    uint64_t lh = a_lo * b_hi;
+    uint64_t hl = a_hi * b_lo;
+    uint64_t hh = a_hi * b_hi;
+
+    uint64_t mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+    uint64_t lo = (mid << 32) | (uint32_t)ll;
+    uint64_t hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+
+    // Add c / 2 for round to nearest
+    uint64_t half = c / 2;
+    lo += half;
+    if (lo < half)
+    {
+        hi++;
+    }
+
+    if (hi == 0)
+    {
+        return lo / c;
+    }
+
+    // Restoring long division, bounded to 128 iterations
+    uint64_t remainder = 0;
+    uint64_t quotient = 0;
+    for (int i = 127; i >= 0; i--)
+    {
+        uint64_t bit = i >= 64 ? (hi >> (i - 64)) & 1 : (lo >> i) & 1;
+        bool carry = (remainder >> 63) != 0;
+
+        remainder = remainder << 1 | bit;
+        quotient <<= 1;
+        if (carry || remainder >= c)
+        {
+            remainder -= c;
+            quotient |= 1;
+        }
+    }
+
+    return quotient;
+}
+
+// |num / den - p / q| scaled by den * q
+static inline uint64_t si5351_rational_error(uint64_t num, uint64_t den, uint64_t p, uint64_t q)
+{
+    uint64_t lhs = num * q;
+    uint64_t rhs = p * den;
+
+    return lhs > rhs ? lhs - rhs : rhs - lhs;
+}
+
+// Best rational approximation b / c of num / den (< 1) with c <= max_den,
+// walks the continued fraction expansion and finishes with the best semiconvergent
+void si5351_best_rational(uint64_t num, uint64_t den, uint32_t max_den, uint32_t *b, uint32_t *c)
+{
+    uint64_t p_prev = 0, q_prev = 1;
+    uint64_t p = 1, q = 0;
+    uint64_t n = num, d = den;
+
+    while (d != 0)
+    {
+        uint64_t term = n / d;
+
+        if (q != 0 && term > (max_den - q_prev) / q)
+        {
+            // Next convergent exceeds the denominator limit, try the largest semiconvergent
+            uint64_t k = (max_den - q_prev) / q;
+            uint64_t p_semi = p_prev + k * p;
+            uint64_t q_semi = q_prev + k * q;
+
+            if (k > 0 &&
+                si5351_rational_error(num, den, p_semi, q_semi) * q < si5351_rational_error(num, den, p, q) * q_semi)
+            {
+                p = p_semi;
+                q = q_semi;
+            }
+            break;
+        }
+
+        uint64_t p_next = term * p + p_prev;
+        uint64_t q_next = term * q + q_prev;
+        p_prev = p;
+        q_prev = q;
+        p = p_next;
+        q = q_next;
+
+        uint64_t r = n - term * d;
+        n = d;
+        d = r;
+    }
+
+    if (q == 0)
+    {
+        // num / den was exactly zero
+        p = 0;
+        q = 1;
+    }
+
+    *b = (uint32_t)p;
+    *c = (uint32_t)q;
+}
+
+// Convert a + b / c to the register representation, AN619 section 3.2
+void si5351_ratio_to_parameters(uint32_t a, uint32_t b, uint32_t c, uint32_t *p1, uint32_t *p2, uint32_t *p3)
+{
+    uint32_t floor_term = (128 * (uint64_t)b) / c;
+
+    *p1 = 128 * a + floor_term - 512;
+    *p2 = 128 * b - c * floor_term;
+    *p3 = c;
+}
+
+// Split num / den into a + b / c with c within the 20 bit P3 range
+static void si5351_approximate_ratio(uint64_t num, uint64_t den, uint32_t *a, uint32_t *b, uint32_t *c)
+{
+    *a = num / den;
+    si5351_best_rational(num % den, den, SI5351_P3_MAX, b, c);
+
+    if (*b == *c)
+    {
+        // Fraction rounded up to a whole
+        (*a)++;
+        *b = 0;
+        *c = 1;
+    }
+}
+
+uint64_t si5351_pll_frequency(uint64_t ref_frequency, si5351_pll_parameters_t const *pll)
+{
+    if (pll->p3 == 0)
+    {
+        return 0;
+    }
+
+    // f_vco = f_ref * (p3 * (p1 + 512) + p2) / (128 * p3)
+    uint64_t num = (uint64_t)pll->p3 * (pll->p1 + 512) + pll->p2;
+    uint64_t den = 128 * (uint64_t)pll->p3;
+
+    return si5351_mul_div_round(ref_frequency, num, den);
+}
+
+uint64_t si5351_multisynth_frequency(uint64_t vco_frequency, si5351_output_parameters_t const *parameters)
+{
+    uint64_t frequency;
+
+    if (parameters->divide_by_four)
+    {
+        frequency = vco_frequency / 4;
+    }
+    else
+    {
+        // f_out = f_vco * 128 * p3 / (p3 * (p1 + 512) + p2)
+        uint64_t num = 128 * (uint64_t)parameters->p3;
+        uint64_t den = (uint64_t)parameters->p3 * (parameters->p1 + 512) + parameters->p2;
+
+        if (den == 0)
+        {
+            return 0;
+        }
+        frequency = si5351_mul_div_round(vco_frequency, num, den);
+    }
+
+    return frequency >> parameters->r;
+}
+
+// VCO frequency needed for a multisynth output frequency, inverse of si5351_multisynth_frequency()
+uint64_t si5351_multisynth_vco_frequency(uint64_t frequency, si5351_output_parameters_t const *parameters)
+{
+    uint64_t ms_frequency = frequency << parameters->r;
+
+    if (parameters->divide_by_four)
+    {
+        return ms_frequency * 4;
+    }
+
+    uint64_t num = (uint64_t)parameters->p3 * (parameters->p1 + 512) + parameters->p2;
+    uint64_t den = 128 * (uint64_t)parameters->p3;
+
+    return den == 0 ? 0 : si5351_mul_div_round(ms_frequency, num, den);
+}
+
+// PLL ratio for a VCO frequency with a fixed denominator, so that consecutive
+// solutions only differ in P2 (and P1 when crossing an integer boundary)
+int si5351_solve_pll_fixed_denominator(uint64_t ref_frequency, uint64_t vco_frequency, uint32_t c,
+                                       si5351_pll_parameters_t *pll)
+{
+    if (ref_frequency == 0 || c == 0 || c > SI5351_P3_MAX ||
+        vco_frequency < SI5351_PLL_VCO_MIN || vco_frequency > SI5351_PLL_VCO_MAX)
+    {
+        return -EINVAL;
+    }
+
+    uint32_t a = vco_frequency / ref_frequency;
+    uint32_t b = si5351_mul_div_round(vco_frequency % ref_frequency, c, ref_frequency);
+    if (b == c)
+    {
+        a++;
+        b = 0;
+    }
+
+    if (a < SI5351_PLL_RATIO_MIN || a > SI5351_PLL_RATIO_MAX || (a == SI5351_PLL_RATIO_MAX && b != 0))
+    {
+        return -EINVAL;
+    }
+
+    uint32_t p1, p2, p3;
+    si5351_ratio_to_parameters(a, b, c, &p1, &p2, &p3);
+    pll->p1 = p1;
+    pll->p2 = p2;
+    pll->p3 = p3;
+
+    return 0;
+}
+
+// PLL feedback for a VCO frequency at a given P3. P1/P2 move in steps of 1 / (128 * P3) of the
+// reference, 128 times finer than a + b / c with the same denominator.
+int si5351_solve_pll_fixed_p3(uint64_t ref_frequency, uint64_t vco_frequency, uint32_t p3, si5351_pll_parameters_t *pll)
+{
+    if (ref_frequency == 0 || p3 == 0 || p3 > SI5351_P3_MAX ||
+        vco_frequency < SI5351_PLL_VCO_MIN || vco_frequency > SI5351_PLL_VCO_MAX)
+    {
+        return -EINVAL;
+    }
+
+    // p3 * (p1 + 512) + p2
+    uint64_t total = si5351_mul_div_round(vco_frequency, 128 * (uint64_t)p3, ref_frequency);
+    if (total < 128ULL * SI5351_PLL_RATIO_MIN * p3 || total > 128ULL * SI5351_PLL_RATIO_MAX * p3)
+    {
+        return -EINVAL;
+    }
+
+    pll->p1 = total / p3 - 512;
+    pll->p2 = total % p3;
+    pll->p3 = p3;
+
+    return 0;
+}
+
+// PLL ratio closest to a VCO frequency
+int si5351_solve_pll(uint64_t ref_frequency, uint64_t vco_frequency, si5351_pll_parameters_t *pll)
+{
+    uint32_t a, b, c;
+    si5351_approximate_ratio(vco_frequency, ref_frequency, &a, &b, &c);
+    if (a < SI5351_PLL_RATIO_MIN || a > SI5351_PLL_RATIO_MAX || (a == SI5351_PLL_RATIO_MAX && b != 0))
+    {
+        return -EINVAL;
+    }
+
+    uint32_t p1, p2, p3;
+    si5351_ratio_to_parameters(a, b, c, &p1, &p2, &p3);
+    pll->p1 = p1;
+    pll->p2 = p2;
+    pll->p3 = p3;
+
+    return 0;
+}
+
+// Even integer multisynth, fractional PLL. Lowest jitter, but the PLL is retuned.
+static int si5351_solve_with_pll(uint64_t ref_frequency, uint64_t ms_frequency, bool integer_only,
+                                 si5351_pll_parameters_t *pll, si5351_output_parameters_t *parameters)
+{
+    uint32_t ms_div;
+
+    if (ms_frequency > SI5351_MULTISYNTH_DIV_BY_4_MIN && !integer_only)
+    {
+        ms_div = 4;
+    }
+    else
+    {
+        ms_div = (SI5351_PLL_VCO_MAX / ms_frequency) & ~1U;
+        ms_div = MIN(ms_div, integer_only ? SI5351_MULTISYNTH_INT_DIV_MAX : SI5351_MULTISYNTH_DIV_MAX);
+        if (integer_only && ms_div < SI5351_MULTISYNTH_INT_DIV_MIN)
+        {
+            return -EINVAL;
+        }
+    }
+
+    uint64_t vco_frequency = ms_frequency * ms_div;
+    if (vco_frequency < SI5351_PLL_VCO_MIN || vco_frequency > SI5351_PLL_VCO_MAX)
+    {
+        return -EINVAL;
+    }
+
+    int ret = si5351_solve_pll(ref_frequency, vco_frequency, pll);
+    if (ret)
+    {
+        return ret;
+    }
+
+    uint32_t p1, p2, p3;
+    if (ms_div == 4)
+    {
+        parameters->p1 = 0;
+        parameters->p2 = 0;
+        parameters->p3 = 1;
+        parameters->divide_by_four = true;
+    }
+    else
+    {
+        si5351_ratio_to_parameters(ms_div, 0, 1, &p1, &p2, &p3);
+        parameters->p1 = p1;
+        parameters->p2 = p2;
+        parameters->p3 = p3;
+        parameters->divide_by_four = false;
+    }
+    parameters->integer_mode = si5351_output_integer_mode_enabled;
+
+    return 0;
+}
+
+// Even integer multisynth ratio and fractional PLL for outputs with phase offsets. Offsets are
+// counted in quarter VCO periods, ratio * phase / 90 of them, so the largest ratio that keeps
+// max_phase (degrees) within the phase offset register gives the finest phase resolution.
+int si5351_solve_phase_coherent(uint64_t ref_frequency, uint64_t frequency, uint16_t max_phase, uint32_t div_max,
+                                si5351_pll_parameters_t *pll, uint32_t *ms_div)
+{
+    if (ref_frequency == 0 || frequency == 0)
+    {
+        return -EINVAL;
+    }
+
+    uint64_t div = MIN(SI5351_PLL_VCO_MAX / frequency, div_max);
+    if (max_phase > 0)
+    {
+        div = MIN(div, SI5351_PHASE_OFFSET_MAX * 90 / max_phase);
+    }
+    div &= ~1ULL;
+
+    uint64_t vco_frequency = frequency * div;
+    if (div < SI5351_MULTISYNTH_DIV_MIN || vco_frequency < SI5351_PLL_VCO_MIN)
+    {
+        return -EINVAL;
+    }
+
+    int ret = si5351_solve_pll(ref_frequency, vco_frequency, pll);
+    if (ret)
+    {
+        return ret;
+    }
+
+    *ms_div = div;
+
+    return 0;
+}
+
+// Fractional multisynth from a PLL that must keep its frequency. Integer-only multisynths
+// only reach the frequencies that divide the VCO by an even integer.
+static int si5351_solve_with_multisynth(uint64_t ref_frequency, uint64_t ms_frequency, bool integer_only,
+                                        si5351_pll_parameters_t const *pll, si5351_output_parameters_t *parameters)
+{
+    uint64_t vco_frequency = si5351_pll_frequency(ref_frequency, pll);
+
+    uint32_t a, b, c;
+    si5351_approximate_ratio(vco_frequency, ms_frequency, &a, &b, &c);
+    if (integer_only)
+    {
+        if (b != 0 || (a & 1) != 0 || a < SI5351_MULTISYNTH_INT_DIV_MIN || a > SI5351_MULTISYNTH_INT_DIV_MAX)
+        {
+            return -EINVAL;
+        }
+    }
+    else if (a < SI5351_MULTISYNTH_DIV_MIN || a > SI5351_MULTISYNTH_DIV_MAX ||
+             (a == SI5351_MULTISYNTH_DIV_MAX && b != 0))
+    {
+        return -EINVAL;
+    }
+
+    uint32_t p1, p2, p3;
+    si5351_ratio_to_parameters(a, b, c, &p1, &p2, &p3);
+    parameters->p1 = p1;
+    parameters->p2 = p2;
+    parameters->p3 = p3;
+    parameters->divide_by_four = false;
+    parameters->integer_mode = (b == 0 && (a & 1) == 0) ? si5351_output_integer_mode_enabled
+                                                        : si5351_output_integer_mode_disabled;
+
+    return 0;
+}
+
+int si5351_solve_output(uint64_t ref_frequency, uint64_t frequency, bool pll_fixed, bool integer_only,
+                        si5351_pll_parameters_t *pll, si5351_output_parameters_t *parameters)
+{
+    if (ref_frequency == 0 || frequency < SI5351_OUTPUT_FREQUENCY_MIN || frequency > SI5351_OUTPUT_FREQUENCY_MAX)
+    {
+        return -EINVAL;
+    }
+
+    // Use the smallest R divider that brings the multisynth within its division range
+    uint64_t vco_frequency = pll_fixed ? si5351_pll_frequency(ref_frequency, pll) : SI5351_PLL_VCO_MIN;
+    uint32_t div_max = integer_only ? SI5351_MULTISYNTH_INT_DIV_MAX : SI5351_MULTISYNTH_DIV_MAX;
+    uint8_t r = 0;
+    while ((frequency << r) * div_max < vco_frequency && r < si5351_output_r_128)
+    {
+        r++;
+    }
+
+    int ret = pll_fixed ? si5351_solve_with_multisynth(ref_frequency, frequency << r, integer_only, pll, parameters)
+                        : si5351_solve_with_pll(ref_frequency, frequency << r, integer_only, pll, parameters);
+    if (ret)
+    {
+        return ret;
+    }
+
+    parameters->r = r;
+    parameters->clock_source = si5351_output_clk_source_multisynth;
+
+    return 0;
+}
+
+// Smallest R divider that brings the multisynth of an output within div_max of the VCO
+static int si5351_allocation_r(uint64_t frequency, uint64_t vco_frequency, uint32_t div_max)
+{
+    for (int r = 0; r <= si5351_output_r_128; r++)
+    {
+        if ((frequency << r) * div_max >= vco_frequency)
+        {
+            return r;
+        }
+    }
+
+    return -EINVAL;
+}
+
+// Multisynth cost of an output at a VCO frequency, see si5351_allocation_cost_t
+static int si5351_allocation_output_cost(si5351_allocation_t const *output, uint64_t vco_frequency)
+{
+    uint32_t div_max = output->integer_only ? SI5351_MULTISYNTH_INT_DIV_MAX : SI5351_MULTISYNTH_DIV_MAX;
+    // Divide by four is not available on the integer-only multisynths of CLK6 and CLK7
+    uint32_t even_div_min = output->integer_only ? SI5351_MULTISYNTH_INT_DIV_MIN : 4;
+    int r = si5351_allocation_r(output->frequency, vco_frequency, div_max);
+    if (r < 0)
+    {
+        return r;
+    }
+
+    uint64_t ms_frequency = output->frequency << r;
+    uint64_t div = vco_frequency / ms_frequency;
+    bool exact = vco_frequency % ms_frequency == 0;
+
+    // Valid ratios are 4, 6 and 8 to div_max, only the even integers run in integer mode
+    if (exact && (div & 1) == 0 && div >= even_div_min && div <= div_max)
+    {
+        return si5351_allocation_cost_even;
+    }
+    if (output->integer_only || div < SI5351_MULTISYNTH_DIV_MIN || div > div_max || (div == div_max && !exact))
+    {
+        return -EINVAL;
+    }
+
+    return exact ? si5351_allocation_cost_odd : si5351_allocation_cost_fractional;
+}
+
+// Summed multisynth cost of the outputs in group_mask
+static int si5351_allocation_group_cost(si5351_allocation_t const *outputs, size_t num_outputs, uint8_t group_mask,
+                                        uint64_t vco_frequency)
+{
+    int cost = 0;
+
+    if (vco_frequency < SI5351_PLL_VCO_MIN || vco_frequency > SI5351_PLL_VCO_MAX)
+    {
+        return -EINVAL;
+    }
+
+    for (size_t i = 0; i < num_outputs; i++)
+    {
+        if (group_mask & BIT(i))
+        {
+            int output_cost = si5351_allocation_output_cost(&outputs[i], vco_frequency);
+            if (output_cost < 0)
+            {
+                return output_cost;
+            }
+            cost += output_cost;
+        }
+    }
+
+    return cost;
+}
+
+// Best VCO frequency for the outputs in group_mask on one PLL. Candidates are the even integer
+// multiples of each output, with the R divider raised so at most SI5351_MULTISYNTH_INT_DIV_MAX / 2
+// of them fall in the VCO range. Returns the multisynth cost times two, plus one if the PLL changes.
+static int si5351_allocation_pll(si5351_allocation_t const *outputs, size_t num_outputs, uint8_t group_mask,
+                                 uint64_t current_vco, bool pinned, uint64_t *vco_frequency)
+{
+    *vco_frequency = current_vco;
+    if (group_mask == 0)
+    {
+        return 0;
+    }
+
+    int cost = si5351_allocation_group_cost(outputs, num_outputs, group_mask, current_vco);
+    int best = cost < 0 ? cost : cost * 2;
+
+    for (size_t i = 0; !pinned && best != 0 && best != 1 && i < num_outputs; i++)
+    {
+        if (!(group_mask & BIT(i)))
+        {
+            continue;
+        }
+
+        int r = si5351_allocation_r(outputs[i].frequency, SI5351_PLL_VCO_MAX, SI5351_MULTISYNTH_INT_DIV_MAX);
+        uint64_t ms_frequency = outputs[i].frequency << (r < 0 ? si5351_output_r_128 : r);
+        uint64_t div = MAX(DIV_ROUND_UP(SI5351_PLL_VCO_MIN, ms_frequency), 4);
+
+        for (div += div & 1; best != 1 && ms_frequency * div <= SI5351_PLL_VCO_MAX; div += 2)
+        {
+            cost = si5351_allocation_group_cost(outputs, num_outputs, group_mask, ms_frequency * div);
+            if (cost >= 0 && (best < 0 || cost * 2 + 1 < best))
+            {
+                best = cost * 2 + 1;
+                *vco_frequency = ms_frequency * div;
+            }
+        }
+    }
+
+    return best;
+}
+
+// Multisynth parameters of an output on a solved PLL. Even integer ratios are taken from the
+// ideal VCO frequency, so a fractional PLL approximation does not turn them fractional.
+static int si5351_allocation_output(uint64_t ref_frequency, si5351_allocation_t *output, uint64_t vco_frequency,
+                                    si5351_pll_parameters_t const *pll)
+{
+    si5351_output_parameters_t *parameters = &output->parameters;
+    uint32_t div_max = output->integer_only ? SI5351_MULTISYNTH_INT_DIV_MAX : SI5351_MULTISYNTH_DIV_MAX;
+    int r = si5351_allocation_r(output->frequency, vco_frequency, div_max);
+    if (r < 0)
+    {
+        return r;
+    }
+
+    parameters->r = r;
+    parameters->clock_source = si5351_output_clk_source_multisynth;
+
+    if (si5351_allocation_output_cost(output, vco_frequency) != si5351_allocation_cost_even)
+    {
+        return si5351_solve_with_multisynth(ref_frequency, output->frequency << r, output->integer_only, pll, parameters);
+    }
+
+    uint32_t div = vco_frequency / (output->frequency << r);
+    uint32_t p1, p2, p3;
+    si5351_ratio_to_parameters(div, 0, 1, &p1, &p2, &p3);
+    parameters->p1 = div == 4 ? 0 : p1;
+    parameters->p2 = p2;
+    parameters->p3 = p3;
+    parameters->divide_by_four = div == 4;
+    parameters->integer_mode = si5351_output_integer_mode_enabled;
+
+    return 0;
+}
+
+int si5351_solve_allocation(uint64_t ref_frequency, si5351_allocation_t *outputs, size_t num_outputs,
+                            si5351_pll_mask_t pinned, si5351_pll_parameters_t pll[2], si5351_pll_mask_t *pll_changed)
+{
+    if (ref_frequency == 0 || num_outputs == 0 || num_outputs > SI5351_NUM_OUTPUTS_MAX)
+    {
+        return -EINVAL;
+    }
+
+    uint8_t current_mask = 0;
+    for (size_t i = 0; i < num_outputs; i++)
+    {
+        if (outputs[i].frequency < SI5351_OUTPUT_FREQUENCY_MIN || outputs[i].frequency > SI5351_OUTPUT_FREQUENCY_MAX)
+        {
+            return -EINVAL;
+        }
+        if (outputs[i].pll == si5351_output_multisynth_source_pllb)
+        {
+            current_mask |= BIT(i);
+        }
+    }
+
+    uint64_t current_vco[2] = {
+        si5351_pll_frequency(ref_frequency, &pll[0]),
+        si5351_pll_frequency(ref_frequency, &pll[1]),
+    };
+    uint32_t best = UINT32_MAX;
+    uint8_t best_mask = 0;
+    uint64_t best_vco[2];
+
+    // Bit i of mask puts output i on PLLB. Ranked by multisynth cost, then PLLs retuned, then
+    // outputs moved to the other PLL, each of which glitches the outputs involved.
+    for (uint32_t mask = 0; mask < BIT(num_outputs); mask++)
+    {
+        uint64_t vco[2];
+        int cost_a = si5351_allocation_pll(outputs, num_outputs, ~mask & (BIT(num_outputs) - 1), current_vco[0],
+                                           pinned & si5351_pll_mask_a, &vco[0]);
+        int cost_b = si5351_allocation_pll(outputs, num_outputs, mask, current_vco[1],
+                                           pinned & si5351_pll_mask_b, &vco[1]);
+        if (cost_a < 0 || cost_b < 0)
+        {
+            continue;
+        }
+
+        uint32_t cost = (cost_a / 2 + cost_b / 2) << 6 | (cost_a % 2 + cost_b % 2) << 4 | POPCOUNT(mask ^ current_mask);
+        if (cost < best)
+        {
+            best = cost;
+            best_mask = mask;
+            best_vco[0] = vco[0];
+            best_vco[1] = vco[1];
+        }
+    }
+
+    if (best == UINT32_MAX)
+    {
+        return -EINVAL;
+    }
+
+    *pll_changed = 0;
+    for (int i = 0; i < 2; i++)
+    {
+        if (best_vco[i] != current_vco[i])
+        {
+            int ret = si5351_solve_pll(ref_frequency, best_vco[i], &pll[i]);
+            if (ret)
+            {
+                return ret;
+            }
+            *pll_changed |= BIT(i);
+        }
+    }
+
+    for (size_t i = 0; i < num_outputs; i++)
+    {
+        int index = (best_mask & BIT(i)) ? 1 : 0;
+
+        outputs[i].pll = index ? si5351_output_multisynth_source_pllb : si5351_output_multisynth_source_plla;
+        outputs[i].cost = si5351_allocation_output_cost(&outputs[i], best_vco[index]);
+
+        int ret = si5351_allocation_output(ref_frequency, &outputs[i], best_vco[index], &pll[index]);
+        if (ret)
+        {
+            return ret;
+        }
+        outputs[i].parameters.multisynth_source = outputs[i].pll;
+    }
+
+    return 0;
+}
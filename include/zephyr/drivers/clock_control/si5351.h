@@ -120,6 +120,12 @@ typedef struct
     uint8_t phase_offset : 7;
 } si5351_output_parameters_t;
 
+typedef enum
+{
+    si5351_parameter_source_cache,  // Driver state, no bus traffic and never blocks
+    si5351_parameter_source_device, // Decoded from a single burst read of the device registers
+} si5351_parameter_source_t;
+
 typedef struct
 {
     bool sys_init;
@@ -136,14 +142,243 @@ typedef enum
     si5351_pll_mask_b = 1 << 1,
 } si5351_pll_mask_t;
 
+#define SI5351_HOP_ENTRY_REGISTERS 8
+
+// Pre-encoded PLL setting for one frequency of a hop table
+typedef struct
+{
+    si5351_pll_parameters_t parameters;
+    uint8_t registers[SI5351_HOP_ENTRY_REGISTERS];
+} si5351_hop_entry_t;
+
+int si5351_get_parameters(const struct device *dev, si5351_parameter_source_t source, si5351_parameters_t *parameters);
+int si5351_set_parameters(const struct device *dev, si5351_parameters_t const *parameters);
+
 int si5351_reset_pll(const struct device *dev, si5351_pll_mask_t pll);
 
-int si5351_output_get_parameters(const struct device *dev, si5351_output_parameters_t *parameters);
+// Changes made between begin and commit are only staged in RAM. The commit writes them
+// in as few bursts as possible, followed by at most one PLL reset and one OEB write.
+// Transactions may be nested, only the outermost commit writes to the device.
+// The device is locked from begin to commit, both must be called from the same thread.
+int si5351_transaction_begin(const struct device *dev);
+int si5351_transaction_commit(const struct device *dev);
+
+// Several chips changed as one. Between begin and commit each member is in a transaction, so the
+// regular calls only stage. The commit writes the dividers of all members, then issues their
+// pending PLL resets back-to-back before waiting for lock, then switches all outputs.
+// With CONFIG_CLOCK_CONTROL_SI5351_RTIO members on different buses are written in parallel.
+// Members are locked in array order, groups sharing devices must list them in the same order.
+typedef struct
+{
+    const struct device *const *devices;
+    size_t num_devices;
+} si5351_group_t;
+
+int si5351_group_begin(si5351_group_t const *group);
+int si5351_group_commit(si5351_group_t const *group);
+
+int si5351_output_get_parameters(const struct device *dev, si5351_parameter_source_t source, si5351_output_parameters_t *parameters);
 int si5351_output_set_parameters(const struct device *dev, si5351_output_parameters_t const *parameters);
 
+// Frequencies in milli-Hz
+int si5351_output_set_frequency(const struct device *dev, uint64_t frequency);
+int si5351_output_get_frequency(const struct device *dev, uint64_t *frequency);
+
+// Hop tables retune the PLL feeding an output, keeping its multisynth fixed.
+// Entries share one P3 so switching between them only rewrites the changed P2 (and P1) bytes,
+// no PLL reset is issued. Other outputs on the same PLL move along proportionally.
+int si5351_output_encode_hop_table(const struct device *dev, uint64_t const *frequencies, si5351_hop_entry_t *entries, size_t num_entries);
+int si5351_output_hop(const struct device *dev, si5351_hop_entry_t const *entry);
+
+// Output of a phase coherent retune, phase in degrees relative to an output at 0
+typedef struct
+{
+    const struct device *output;
+    uint16_t phase;
+} si5351_output_phase_t;
+
+// Moves all outputs of dev to one frequency (milli-Hz) on the PLL of the first output, with even
+// integer multisynths, their phase offsets and a PLL reset written in one transaction.
+// Phases of 180 degrees and more use the output inverter. Offsets are whole quarter VCO periods
+// of at most 127, so a 90 degree step needs a frequency above about 4.7 MHz.
+// The PLL must not feed any other powered output, -EBUSY otherwise.
+int si5351_set_frequency_coherent(const struct device *dev, uint64_t frequency, si5351_output_phase_t const *outputs,
+                                  size_t num_outputs);
+
+#define SI5351_FREQUENCY_PLAN_OUTPUTS_MAX 8
+
+// Requested frequency (milli-Hz) of one output for the PLL allocation planner
+typedef struct
+{
+    const struct device *output;
+    uint64_t frequency;
+} si5351_output_request_t;
+
+// Result of si5351_plan_frequencies(), parameters[i] belongs to outputs[i]
+typedef struct
+{
+    si5351_pll_parameters_t plla;
+    si5351_pll_parameters_t pllb;
+    si5351_pll_mask_t pll_reset; // PLLs retuned by the plan
+    uint8_t num_fractional;      // Outputs left with a fractional or odd integer multisynth
+    size_t num_outputs;
+    const struct device *outputs[SI5351_FREQUENCY_PLAN_OUTPUTS_MAX];
+    si5351_output_parameters_t parameters[SI5351_FREQUENCY_PLAN_OUTPUTS_MAX];
+} si5351_frequency_plan_t;
+
+// Chooses which PLL each requested output runs from and both VCO frequencies. Plans are ranked by
+// the number of outputs without an even integer multisynth, then by PLLs retuned, then by outputs
+// moved to the other PLL. A PLL feeding powered outputs outside the request keeps its frequency.
+// All 2^n PLL assignments are searched, so this is meant for setup rather than fast retuning.
+int si5351_plan_frequencies(const struct device *dev, si5351_output_request_t const *requests, size_t num_requests,
+                            si5351_frequency_plan_t *plan);
+// Writes a plan in one transaction, with at most one PLL reset
+int si5351_apply_frequency_plan(const struct device *dev, si5351_frequency_plan_t const *plan);
+
+#define SI5351_XTAL_CORRECTION_PPB_MAX 1000000
+
+// Calibration of the crystal against its devicetree frequency, positive when it runs fast.
+// PLLs from the crystal that feed powered outputs are solved again for their previous VCO
+// frequency and only their changed bytes written, without a PLL reset. Multisynths are not
+// touched. Everything planned later uses the corrected reference.
+int si5351_set_xtal_correction(const struct device *dev, int32_t ppb);
+// Crystal frequency in milli-Hz with the correction applied, and the correction itself
+int si5351_get_xtal_frequency(const struct device *dev, uint64_t *frequency, int32_t *ppb);
+
 int si5351_tune_pll(const struct device *dev, si5351_pll_mask_t pll_mask, si5351_pll_parameters_t const *parameters);
 int si5351_set_output(const struct device *dev, uint8_t output_index, si5351_output_output_t state);
 
+// With CONFIG_CLOCK_CONTROL_SI5351_INTERRUPT and int-gpios this returns the status cached by the
+// interrupt service without bus traffic, as long as no serviced source is active.
 int si5351_get_status(const struct device *dev, si5351_status_t *status);
 
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_INTERRUPT
+#include <zephyr/sys/slist.h>
+
+typedef enum
+{
+    si5351_event_xtal_loss_of_signal = 1 << 0,
+    si5351_event_clkin_loss_of_signal = 1 << 1,
+    si5351_event_plla_loss_of_lock = 1 << 2,
+    si5351_event_pllb_loss_of_lock = 1 << 3,
+} si5351_event_t;
+
+typedef struct si5351_event_callback si5351_event_callback_t;
+
+// Called from the driver work queue with the si5351_event_t bits latched since the last call
+// that the callback asked for, and the status at the time. Loss of lock caused by a PLL reset
+// of the driver itself is not reported.
+typedef void (*si5351_event_handler_t)(const struct device *dev, si5351_event_callback_t *callback, uint8_t events,
+                                       si5351_status_t const *status);
+
+struct si5351_event_callback
+{
+    sys_snode_t node;
+    si5351_event_handler_t handler;
+    uint8_t events;
+};
+
+// -ENOTSUP when the device has no int-gpios
+int si5351_add_event_callback(const struct device *dev, si5351_event_callback_t *callback);
+int si5351_remove_event_callback(const struct device *dev, si5351_event_callback_t *callback);
+#endif
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_ASYNC
+struct k_poll_signal;
+
+// Queue a change to the driver work queue and return immediately. The signal, if given,
+// is raised with the result once written, or with -ECANCELED if a newer request replaced it.
+int si5351_output_set_parameters_async(const struct device *dev, si5351_output_parameters_t const *parameters,
+                                       struct k_poll_signal *signal);
+int si5351_tune_pll_async(const struct device *dev, si5351_pll_mask_t pll_mask, si5351_pll_parameters_t const *parameters,
+                          struct k_poll_signal *signal);
+#endif
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_STATS
+// Clears the bus counters and latency histograms, registered with the stats subsystem under the device name
+int si5351_stats_reset(const struct device *dev);
+#endif
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_SEQUENCER
+// One step of a sweep or hop pattern. Steps with a non-zero frequency (milli-Hz) are
+// encoded into hop when the sequence is started, otherwise hop must already be encoded.
+typedef struct
+{
+    uint64_t frequency;
+    uint32_t dwell_us;
+    si5351_hop_entry_t hop;
+} si5351_sequence_step_t;
+
+// Called from the sequencer thread with 0 when the last step has dwelt,
+// -ECANCELED after si5351_sequencer_stop() or the error of a failed write
+typedef void (*si5351_sequencer_callback_t)(const struct device *dev, int result, void *user_data);
+
+typedef struct
+{
+    const struct device *output;
+    si5351_sequence_step_t *steps;
+    size_t num_steps;
+    si5351_sequencer_callback_t callback;
+    void *user_data;
+    bool loop;
+
+    // Maintained by the sequencer, reset on start
+    uint32_t iterations;
+    uint32_t max_lateness_us;
+} si5351_sequencer_t;
+
+// Steps are written from a dedicated high priority thread at absolute deadlines, so timing
+// errors do not accumulate. max_lateness_us records the worst step start error seen.
+// Only one sequence runs at a time, starting another returns -EBUSY.
+int si5351_sequencer_start(si5351_sequencer_t *sequencer);
+int si5351_sequencer_stop(si5351_sequencer_t *sequencer);
+// Takes effect at the end of the current pass
+void si5351_sequencer_set_loop(si5351_sequencer_t *sequencer, bool loop);
+#endif
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_DISCIPLINE
+#include <zephyr/kernel.h>
+
+// Frequency error of the disciplined output against an external reference in ppb, positive when
+// the output runs fast. -EAGAIN when no new measurement is available, the step is skipped then.
+typedef int (*si5351_discipline_measure_t)(const struct device *output, int32_t *error_ppb, void *user_data);
+
+typedef struct
+{
+    const struct device *output;
+    si5351_discipline_measure_t measure;
+    void *user_data;
+    uint32_t interval_ms;
+    // PI gains in 1/65536, ppb of correction per ppb of error
+    int32_t kp;
+    int32_t ki;
+    // Bound on the correction and the integrator, 0 for SI5351_XTAL_CORRECTION_PPB_MAX
+    int32_t max_correction_ppb;
+    // Locked after lock_count consecutive measurements within lock_threshold_ppb
+    int32_t lock_threshold_ppb;
+    uint8_t lock_count;
+
+    // Maintained by the service, reset on start
+    bool locked;
+    int32_t residual_ppb;
+    int32_t correction_ppb;
+    uint32_t samples;
+
+    // Internal
+    bool running;
+    struct k_work_delayable work;
+    si5351_pll_mask_t pll_mask;
+    uint64_t vco_frequency;
+    int64_t integrator;
+    uint8_t in_threshold;
+} si5351_discipline_t;
+
+// Steers the PLL feeding the output, and every other output on it, from the driver work queue.
+// Each step writes a new P1/P2 at a fixed P3, usually two or three bytes, without a PLL reset.
+// Measurements taken while the PLL is out of lock are dropped and clear the lock state.
+// The struct must be zero-initialized before the first start, a designated initializer does that.
+int si5351_discipline_start(si5351_discipline_t *discipline);
+int si5351_discipline_stop(si5351_discipline_t *discipline);
+#endif
+
 #endif // ZEPHYR_INCLUDE_DRIVERS_CLOCK_CONTROL_SI5351_H_
\ No newline at end of file
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2025 Jonatan Gezelius
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_DRIVERS_CLOCK_CONTROL_SI5351_EMUL_H_
+#define ZEPHYR_INCLUDE_DRIVERS_CLOCK_CONTROL_SI5351_EMUL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/drivers/emul.h>
+
+// Bus cost seen by the emulator since power-up or the last reset of the counters
+typedef struct
+{
+    uint32_t transactions;
+    uint32_t bytes_written;
+    uint32_t bytes_read;
+    // Clock cycles on the wire, start, address and data bytes with their ACK, stop
+    uint32_t bits;
+} si5351_emul_stats_t;
+
+void si5351_emul_get_stats(const struct emul *target, si5351_emul_stats_t *stats);
+void si5351_emul_reset_stats(const struct emul *target);
+
+// Modelled transfer time in microseconds at the given SCL frequency
+static inline uint32_t si5351_emul_bus_time_us(si5351_emul_stats_t const *stats, uint32_t bus_frequency)
+{
+    return ((uint64_t)stats->bits * 1000000 + bus_frequency - 1) / bus_frequency;
+}
+
+// Direct register file access, bypassing the bus and its counters
+int si5351_emul_get_reg(const struct emul *target, uint8_t reg, uint8_t *value);
+int si5351_emul_set_reg(const struct emul *target, uint8_t reg, uint8_t value);
+
+// Restarts the device as after power-up, SYS_INIT is set and the register file back to defaults
+void si5351_emul_power_up(const struct emul *target);
+
+// Time the LOL bit of a PLL stays set after a write to the PLL reset register
+void si5351_emul_set_lock_time(const struct emul *target, uint32_t lock_time_us);
+
+// Conditions reported as loss of signal in the status register until cleared again.
+// With int-gpios on an emulated GPIO controller the INTR pin follows the sticky bits.
+void si5351_emul_set_loss_of_signal(const struct emul *target, bool xtal, bool clkin);
+
+// Deviation of the emulated crystal from its devicetree frequency, positive when it runs fast
+void si5351_emul_set_xtal_error(const struct emul *target, int32_t ppb);
+
+// Frequency in milli-Hz currently present on an output, as derived from the register file.
+// 0 while the output is powered down or disabled, -ENOTSUP for CLKIN referenced outputs.
+int si5351_emul_get_output_frequency(const struct emul *target, uint8_t output_index, uint64_t *frequency);
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_DISCIPLINE
+#include <zephyr/device.h>
+
+// Simulated reference for the discipline service, compares an emulated output against the
+// frequency in milli-Hz it should have. Pass as user_data with si5351_emul_discipline_measure.
+typedef struct
+{
+    const struct emul *emul;
+    uint8_t output_index;
+    uint64_t frequency;
+} si5351_emul_discipline_source_t;
+
+int si5351_emul_discipline_measure(const struct device *output, int32_t *error_ppb, void *user_data);
+#endif
+
+#endif // ZEPHYR_INCLUDE_DRIVERS_CLOCK_CONTROL_SI5351_EMUL_H_
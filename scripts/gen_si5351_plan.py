@@ -0,0 +1,349 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 Jonatan Gezelius
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Build time frequency planner for skyworks,si5351 devicetree nodes.
+
+Outputs with a clock-frequency property get their multisynth and PLL
+parameters solved here, using the same integer algorithm as
+drivers/clock_control/si5351_solver.c. The result is emitted as a header
+of plain defines keyed on the devicetree dependency ordinal, which the
+SI5351_INIT / SI5351_OUTPUT_INIT macros pick up in place of the raw
+p1/p2/p3 properties.
+
+The header also holds the complete initial register image of every
+device, encoded the same way as the driver does at runtime, for
+CONFIG_CLOCK_CONTROL_SI5351_INIT_IMAGE.
+"""
+
+import argparse
+import os
+import pickle
+import sys
+
+MILLIHZ_PER_HZ = 1000
+PLL_VCO_MIN = 600000000 * MILLIHZ_PER_HZ
+PLL_VCO_MAX = 900000000 * MILLIHZ_PER_HZ
+PLL_RATIO_MIN = 15
+PLL_RATIO_MAX = 90
+MULTISYNTH_DIV_MIN = 8
+MULTISYNTH_DIV_MAX = 2048
+MULTISYNTH_INT_DIV_MIN = 6
+MULTISYNTH_INT_DIV_MAX = 254
+INTEGER_OUTPUT_FIRST = 6
+MULTISYNTH_DIV_BY_4_MIN = 150000000 * MILLIHZ_PER_HZ
+OUTPUT_FREQUENCY_MIN = PLL_VCO_MIN // (MULTISYNTH_DIV_MAX * 128) + 1
+OUTPUT_FREQUENCY_MAX = 200000000 * MILLIHZ_PER_HZ
+P3_MAX = 0xfffff
+R_MAX_SHIFT = 7
+
+# Register map, see drivers/clock_control/si5351.h
+REG_MAP_SIZE = 0xbc
+REG_INTERRUPT = 0x01
+REG_INTERRUPT_MASK = 0x02
+REG_OEB = 0x03
+REG_OEB_MASK = 0x09
+REG_PLL_CFG = 0x0f
+REG_CLK_CTRL = 0x10
+REG_PLL = 0x1a
+REG_MULTISYNTH = 0x2a
+REG_MULTISYNTH_INT = 0x5a
+REG_MULTISYNTH_INT_R = 0x5c
+REG_PHASE_OFFSET = 0xa5
+REG_XTAL_LOAD = 0xb7
+PHASE_OFFSET_OUTPUTS = 6
+
+MODEL_OUTPUTS = {
+    "si5351a-b-gt": 3,
+    "si5351a-b-gm1": 4,
+    "si5351a-b-gm": 8,
+    "si5351b-b-gm1": 4,
+    "si5351b-b-gm": 8,
+    "si5351c-b-gm1": 4,
+    "si5351c-b-gm": 8,
+}
+CLKIN_DIV = {1: 0, 2: 1, 4: 2, 8: 3}
+XTAL_LOAD = {6: 1, 8: 2, 10: 3}
+PLL_SOURCE = {"XTAL": 0, "CLKin": 1}
+CLK_SOURCE = {"xtal": 0, "clkin": 1, "multisynth": 3}
+DRIVE_STRENGTH = {2: 0, 4: 1, 6: 2, 8: 3}
+
+
+class PlanError(Exception):
+    pass
+
+
+def mul_div_round(a, b, c):
+    return (a * b + c // 2) // c
+
+
+def best_rational(num, den, max_den):
+    """Best rational approximation b / c of num / den with c <= max_den."""
+    p_prev, q_prev = 0, 1
+    p, q = 1, 0
+    n, d = num, den
+
+    while d != 0:
+        term = n // d
+        if q != 0 and term > (max_den - q_prev) // q:
+            k = (max_den - q_prev) // q
+            p_semi = p_prev + k * p
+            q_semi = q_prev + k * q
+            if k > 0 and abs(num * q_semi - p_semi * den) * q < abs(num * q - p * den) * q_semi:
+                p, q = p_semi, q_semi
+            break
+        p_prev, q_prev, p, q = p, q, term * p + p_prev, term * q + q_prev
+        n, d = d, n - term * d
+
+    if q == 0:
+        return 0, 1
+    return p, q
+
+
+def ratio_to_parameters(a, b, c):
+    floor_term = (128 * b) // c
+    return 128 * a + floor_term - 512, 128 * b - c * floor_term, c
+
+
+def approximate_ratio(num, den):
+    a = num // den
+    b, c = best_rational(num % den, den, P3_MAX)
+    if b == c:
+        return a + 1, 0, 1
+    return a, b, c
+
+
+def pll_frequency(ref_frequency, p1, p2, p3):
+    return mul_div_round(ref_frequency * MILLIHZ_PER_HZ, p3 * (p1 + 512) + p2, 128 * p3)
+
+
+def solve_output(ref_frequency, frequency, pll, integer_only=False):
+    """
+    Solve one output. When pll is None the PLL is free and is solved
+    together with an even integer multisynth, otherwise pll is a
+    (p1, p2, p3) tuple that must be kept. integer_only restricts the
+    multisynth to the even ratios of CLK6 and CLK7.
+    """
+    if frequency < OUTPUT_FREQUENCY_MIN or frequency > OUTPUT_FREQUENCY_MAX:
+        raise PlanError(f"{frequency} mHz is outside the output range")
+
+    div_max = MULTISYNTH_INT_DIV_MAX if integer_only else MULTISYNTH_DIV_MAX
+    vco = PLL_VCO_MIN if pll is None else pll_frequency(ref_frequency, *pll)
+    r = 0
+    while (frequency << r) * div_max < vco and r < R_MAX_SHIFT:
+        r += 1
+    ms_frequency = frequency << r
+
+    out = {"r": 1 << r, "divide_by_four": False}
+
+    if pll is None:
+        if ms_frequency > MULTISYNTH_DIV_BY_4_MIN and not integer_only:
+            ms_div = 4
+        else:
+            ms_div = min((PLL_VCO_MAX // ms_frequency) & ~1, div_max)
+            if integer_only and ms_div < MULTISYNTH_INT_DIV_MIN:
+                raise PlanError(f"{frequency} mHz is above the integer-only multisynth range")
+        vco = ms_frequency * ms_div
+        if vco < PLL_VCO_MIN or vco > PLL_VCO_MAX:
+            raise PlanError(f"{frequency} mHz has no valid VCO")
+
+        a, b, c = approximate_ratio(vco, ref_frequency * MILLIHZ_PER_HZ)
+        if a < PLL_RATIO_MIN or a > PLL_RATIO_MAX or (a == PLL_RATIO_MAX and b != 0):
+            raise PlanError(f"{frequency} mHz needs an out of range PLL ratio")
+        pll = ratio_to_parameters(a, b, c)
+
+        if ms_div == 4:
+            out.update(p1=0, p2=0, p3=1, divide_by_four=True)
+        else:
+            out.update(zip(("p1", "p2", "p3"), ratio_to_parameters(ms_div, 0, 1)))
+        out["integer_mode"] = True
+    else:
+        a, b, c = approximate_ratio(vco, ms_frequency)
+        if integer_only:
+            if b != 0 or a % 2 != 0 or a < MULTISYNTH_INT_DIV_MIN or a > MULTISYNTH_INT_DIV_MAX:
+                raise PlanError(f"{frequency} mHz is not an even integer division of the shared PLL")
+        elif a < MULTISYNTH_DIV_MIN or a > MULTISYNTH_DIV_MAX or (a == MULTISYNTH_DIV_MAX and b != 0):
+            raise PlanError(f"{frequency} mHz is out of reach of the shared PLL")
+        out.update(zip(("p1", "p2", "p3"), ratio_to_parameters(a, b, c)))
+        out["integer_mode"] = b == 0 and a % 2 == 0
+
+    return pll, out
+
+
+def plan_device(node):
+    """Returns ({pll_name: (p1, p2, p3)}, {output_node: parameters})."""
+    ref_frequency = node.props["xtal-frequency"].val
+    plls = {}
+    outputs = {}
+
+    children = sorted((c for c in node.children.values() if c.status == "okay"),
+                      key=lambda c: c.regs[0].addr)
+
+    for pll_name in ("PLLA", "PLLB"):
+        on_pll = [c for c in children if c.props["multisynth-source"].val == pll_name]
+        planned = [c for c in on_pll if "clock-frequency" in c.props]
+        if not planned:
+            continue
+
+        prefix = pll_name.lower()
+        if node.props[f"{prefix}-clock-source"].val != "XTAL":
+            raise PlanError(f"{node.path}: {pll_name} must be fed from XTAL for clock-frequency planning")
+
+        # Outputs with raw dividers on the same PLL pin its frequency to the devicetree values
+        pll = None
+        if len(planned) != len(on_pll):
+            pll = tuple(node.props[f"{prefix}-{p}"].val for p in ("p1", "p2", "p3"))
+
+        for child in planned:
+            if child.props["clock-source"].val != "multisynth":
+                raise PlanError(f"{child.path}: clock-frequency requires clock-source = \"multisynth\"")
+            frequency = child.props["clock-frequency"].val * MILLIHZ_PER_HZ
+            try:
+                integer_only = child.regs[0].addr >= INTEGER_OUTPUT_FIRST
+                solved_pll, outputs[child] = solve_output(ref_frequency, frequency, pll, integer_only)
+            except PlanError as e:
+                raise PlanError(f"{child.path}: {e}") from e
+            if pll is None:
+                # First planned output owns the PLL, the rest share it
+                pll = solved_pll
+                plls[pll_name] = pll
+
+    return plls, outputs
+
+
+def encode_parameters(p1, p2, p3):
+    return [
+        (p3 >> 8) & 0xff,
+        p3 & 0xff,
+        (p1 >> 16) & 0x03,
+        (p1 >> 8) & 0xff,
+        p1 & 0xff,
+        ((p3 >> 16) & 0x0f) << 4 | ((p2 >> 16) & 0x0f),
+        (p2 >> 8) & 0xff,
+        p2 & 0xff,
+    ]
+
+
+def register_image(node, plls, outputs):
+    """Initial register map of a device, as si5351_write_configuration() leaves it."""
+    regs = [0] * REG_MAP_SIZE
+    props = node.props
+    num_outputs = MODEL_OUTPUTS[props["model"].val]
+
+    regs[REG_INTERRUPT_MASK] = 0xf8
+    regs[REG_OEB_MASK] = 0xff
+    regs[REG_PLL_CFG] = (CLKIN_DIV[props["clkin-div"].val] << 6 |
+                         PLL_SOURCE[props["pllb-clock-source"].val] << 3 |
+                         PLL_SOURCE[props["plla-clock-source"].val] << 2)
+    regs[REG_XTAL_LOAD] = XTAL_LOAD[props["xtal-load"].val] << 6 | 0x12
+
+    for index, pll_name in enumerate(("PLLA", "PLLB")):
+        prefix = pll_name.lower()
+        pll = plls.get(pll_name) or tuple(props[f"{prefix}-{p}"].val for p in ("p1", "p2", "p3"))
+        regs[REG_PLL + 8 * index:REG_PLL + 8 * index + 8] = encode_parameters(*pll)
+
+    oeb = 0xff
+    children = {c.regs[0].addr: c for c in node.children.values() if c.status == "okay"}
+    for index in range(num_outputs):
+        child = children.get(index)
+        if child is None:
+            regs[REG_CLK_CTRL + index] = 0x80
+            continue
+
+        cprops = child.props
+        ms = outputs.get(child) or {
+            "p1": cprops["p1"].val, "p2": cprops["p2"].val, "p3": cprops["p3"].val, "r": cprops["r"].val,
+            "integer_mode": cprops["integer-mode"].val, "divide_by_four": cprops["divide-by-four"].val,
+        }
+        r = ms["r"].bit_length() - 1
+
+        if cprops["output-enabled"].val:
+            oeb &= ~(1 << index)
+        regs[REG_CLK_CTRL + index] = ((0 if cprops["powered-up"].val else 0x80) |
+                                      int(ms["integer_mode"]) << 6 |
+                                      int(cprops["multisynth-source"].val == "PLLB") << 5 |
+                                      int(cprops["invert"].val) << 4 |
+                                      CLK_SOURCE[cprops["clock-source"].val] << 2 |
+                                      DRIVE_STRENGTH[cprops["drive-strength"].val])
+
+        if index >= PHASE_OFFSET_OUTPUTS:
+            regs[REG_MULTISYNTH_INT + index - PHASE_OFFSET_OUTPUTS] = (ms["p1"] + 512) // 128
+            regs[REG_MULTISYNTH_INT_R] |= r << (4 * (index - PHASE_OFFSET_OUTPUTS))
+        else:
+            if ms["divide_by_four"]:
+                block = encode_parameters(0, 0, 1)
+                block[2] |= 0x03 << 2
+            else:
+                block = encode_parameters(ms["p1"], ms["p2"], ms["p3"])
+            block[2] |= r << 4
+            regs[REG_MULTISYNTH + 8 * index:REG_MULTISYNTH + 8 * index + 8] = block
+            regs[REG_PHASE_OFFSET + index] = cprops["phase-offset"].val & 0x7f
+
+    regs[REG_OEB] = oeb
+    return regs
+
+
+def write_header(out, devices):
+    out.write("/* Generated by gen_si5351_plan.py, do not edit */\n\n")
+    out.write("#ifndef SI5351_PLAN_H_\n#define SI5351_PLAN_H_\n\n")
+
+    for node, (plls, outputs) in devices:
+        out.write(f"/* {node.path} */\n")
+        image = register_image(node, plls, outputs)
+        out.write(f"#define SI5351_PLAN_ORD_{node.dep_ordinal}_IMAGE \\\n    {{")
+        for i in range(0, REG_MAP_SIZE, 12):
+            line = ", ".join(f"0x{b:02x}" for b in image[i:i + 12])
+            out.write(f"{line}, \\\n     " if i + 12 < REG_MAP_SIZE else f"{line}}}\n")
+        for pll_name, (p1, p2, p3) in plls.items():
+            prefix = f"SI5351_PLAN_ORD_{node.dep_ordinal}_{pll_name}"
+            out.write(f"#define {prefix}_PLANNED 1\n")
+            out.write(f"#define {prefix}_P1 {p1}\n")
+            out.write(f"#define {prefix}_P2 {p2}\n")
+            out.write(f"#define {prefix}_P3 {p3}\n")
+        for child, parameters in outputs.items():
+            prefix = f"SI5351_PLAN_ORD_{child.dep_ordinal}"
+            out.write(f"/* {child.path} */\n")
+            out.write(f"#define {prefix}_PLANNED 1\n")
+            out.write(f"#define {prefix}_P1 {parameters['p1']}\n")
+            out.write(f"#define {prefix}_P2 {parameters['p2']}\n")
+            out.write(f"#define {prefix}_P3 {parameters['p3']}\n")
+            out.write(f"#define {prefix}_R {parameters['r']}\n")
+            out.write(f"#define {prefix}_INTEGER_MODE {int(parameters['integer_mode'])}\n")
+            out.write(f"#define {prefix}_DIVIDE_BY_FOUR {int(parameters['divide_by_four'])}\n")
+        out.write("\n")
+
+    out.write("#endif /* SI5351_PLAN_H_ */\n")
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--zephyr-base", required=True, help="Zephyr tree, used to import edtlib")
+    parser.add_argument("--edt-pickle", required=True, help="edt.pickle from the devicetree build step")
+    parser.add_argument("--header-out", required=True, help="Generated header path")
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+
+    sys.path.insert(0, os.path.join(args.zephyr_base, "scripts", "dts", "python-devicetree", "src"))
+    with open(args.edt_pickle, "rb") as f:
+        edt = pickle.load(f)
+
+    devices = []
+    try:
+        for node in edt.compat2okay.get("skyworks,si5351", []):
+            devices.append((node, plan_device(node)))
+    except PlanError as e:
+        sys.exit(f"gen_si5351_plan.py: error: {e}")
+
+    os.makedirs(os.path.dirname(args.header_out), exist_ok=True)
+    with open(args.header_out, "w") as f:
+        write_header(f, devices)
+
+
+if __name__ == "__main__":
+    main()
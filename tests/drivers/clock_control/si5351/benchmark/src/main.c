@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2025 Jonatan Gezelius
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Bus cost of the si5351 hot paths against an emulated device. Every operation prints one
+// line of the form
+//   SI5351_BENCH {"op":"...","transactions":N,"bytes_written":N,"bytes_read":N,"bits":N,
+//                 "time_100khz_us":N,"time_400khz_us":N}
+// and fails if it exceeds its budget in thresholds.h.
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/clock_control/si5351.h>
+#include <zephyr/drivers/clock_control/si5351_emul.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "thresholds.h"
+
+#define SI5351_BENCH_BUS_STANDARD 100000
+#define SI5351_BENCH_BUS_FAST     400000
+
+static const struct device *const si5351_dev = DEVICE_DT_GET(DT_NODELABEL(si5351));
+static const struct device *const clk0_dev = DEVICE_DT_GET(DT_NODELABEL(clk0));
+static const struct emul *const si5351_emul = EMUL_DT_GET(DT_NODELABEL(si5351));
+
+static si5351_emul_stats_t si5351_bench_init_stats;
+
+static void si5351_bench_report(const char *op, si5351_emul_stats_t const *stats)
+{
+    printk("SI5351_BENCH {\"op\":\"%s\",\"transactions\":%u,\"bytes_written\":%u,\"bytes_read\":%u,"
+           "\"bits\":%u,\"time_100khz_us\":%u,\"time_400khz_us\":%u}\n",
+           op, stats->transactions, stats->bytes_written, stats->bytes_read, stats->bits,
+           si5351_emul_bus_time_us(stats, SI5351_BENCH_BUS_STANDARD), si5351_emul_bus_time_us(stats, SI5351_BENCH_BUS_FAST));
+}
+
+#define SI5351_BENCH_CHECK(stats, OP)                                                          \
+    do                                                                                         \
+    {                                                                                          \
+        zassert_true((stats)->transactions <= SI5351_BENCH_##OP##_MAX_TRANSACTIONS,            \
+                     #OP ": %u transactions, budget %u", (stats)->transactions,                \
+                     SI5351_BENCH_##OP##_MAX_TRANSACTIONS);                                    \
+        zassert_true((stats)->bytes_written <= SI5351_BENCH_##OP##_MAX_BYTES_WRITTEN,          \
+                     #OP ": %u bytes written, budget %u", (stats)->bytes_written,              \
+                     SI5351_BENCH_##OP##_MAX_BYTES_WRITTEN);                                   \
+        zassert_true((stats)->bytes_read <= SI5351_BENCH_##OP##_MAX_BYTES_READ,                \
+                     #OP ": %u bytes read, budget %u", (stats)->bytes_read,                    \
+                     SI5351_BENCH_##OP##_MAX_BYTES_READ);                                      \
+    } while (0)
+
+// Counts the bus traffic of a single call, the state it starts from is set up unmeasured
+#define SI5351_BENCH_MEASURE(call, stats)          \
+    do                                             \
+    {                                              \
+        si5351_emul_reset_stats(si5351_emul);      \
+        zassert_ok(call);                          \
+        si5351_emul_get_stats(si5351_emul, stats); \
+    } while (0)
+
+ZTEST(si5351_benchmark, test_init)
+{
+    si5351_bench_report("init", &si5351_bench_init_stats);
+    SI5351_BENCH_CHECK(&si5351_bench_init_stats, INIT);
+}
+
+ZTEST(si5351_benchmark, test_tune_pll)
+{
+    si5351_parameters_t parameters;
+    si5351_emul_stats_t stats;
+
+    zassert_ok(si5351_get_parameters(si5351_dev, si5351_parameter_source_cache, &parameters));
+    si5351_pll_parameters_t pll = parameters.plla;
+
+    pll.p1 = 3456;
+    zassert_ok(si5351_tune_pll(si5351_dev, si5351_pll_mask_a, &pll));
+    pll.p1 = 3328;
+    SI5351_BENCH_MEASURE(si5351_tune_pll(si5351_dev, si5351_pll_mask_a, &pll), &stats);
+
+    si5351_bench_report("tune_pll", &stats);
+    SI5351_BENCH_CHECK(&stats, TUNE_PLL);
+}
+
+ZTEST(si5351_benchmark, test_set_output)
+{
+    si5351_emul_stats_t stats;
+
+    zassert_ok(si5351_set_output(si5351_dev, 1, si5351_output_output_enabled));
+    SI5351_BENCH_MEASURE(si5351_set_output(si5351_dev, 1, si5351_output_output_disabled), &stats);
+
+    si5351_bench_report("set_output", &stats);
+    SI5351_BENCH_CHECK(&stats, SET_OUTPUT);
+}
+
+ZTEST(si5351_benchmark, test_output_set_parameters)
+{
+    si5351_output_parameters_t parameters;
+    si5351_emul_stats_t stats;
+
+    zassert_ok(si5351_output_get_parameters(clk0_dev, si5351_parameter_source_cache, &parameters));
+
+    parameters.invert = si5351_output_invert_disabled;
+    zassert_ok(si5351_output_set_parameters(clk0_dev, &parameters));
+    parameters.invert = si5351_output_invert_enabled;
+    SI5351_BENCH_MEASURE(si5351_output_set_parameters(clk0_dev, &parameters), &stats);
+
+    si5351_bench_report("output_set_parameters", &stats);
+    SI5351_BENCH_CHECK(&stats, OUTPUT_SET_PARAMETERS);
+}
+
+static void *si5351_benchmark_setup(void)
+{
+    zassert_true(device_is_ready(si5351_dev), "si5351 not ready");
+    zassert_true(device_is_ready(clk0_dev), "clk0 not ready");
+
+    // Nothing but the driver initialization has used the bus so far
+    si5351_emul_get_stats(si5351_emul, &si5351_bench_init_stats);
+    return NULL;
+}
+
+ZTEST_SUITE(si5351_benchmark, NULL, si5351_benchmark_setup, NULL, NULL, NULL);
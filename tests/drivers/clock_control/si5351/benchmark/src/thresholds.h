@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2025 Jonatan Gezelius
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SI5351_BENCH_THRESHOLDS_H_
+#define SI5351_BENCH_THRESHOLDS_H_
+
+// Bus cost budget per operation for the configuration in boards/native_sim.overlay.
+// Exceeding any of these fails the suite, lower them whenever a change makes a path cheaper.
+// The RTIO variant is held to the same budgets, each chained run is still one bus transaction.
+
+// Status read in setup, SYS_INIT poll, power-down, sticky clear, configuration, PLL reset, LOL poll, OEB
+#define SI5351_BENCH_INIT_MAX_TRANSACTIONS                  13
+#define SI5351_BENCH_INIT_MAX_BYTES_WRITTEN                 75
+#define SI5351_BENCH_INIT_MAX_BYTES_READ                    3
+
+// Integer retune of PLLA, only the changed P1 byte
+#define SI5351_BENCH_TUNE_PLL_MAX_TRANSACTIONS              1
+#define SI5351_BENCH_TUNE_PLL_MAX_BYTES_WRITTEN             2
+#define SI5351_BENCH_TUNE_PLL_MAX_BYTES_READ                0
+
+// One output disabled, the OEB register
+#define SI5351_BENCH_SET_OUTPUT_MAX_TRANSACTIONS            1
+#define SI5351_BENCH_SET_OUTPUT_MAX_BYTES_WRITTEN           2
+#define SI5351_BENCH_SET_OUTPUT_MAX_BYTES_READ              0
+
+// Output inverted, its CLK control register
+#define SI5351_BENCH_OUTPUT_SET_PARAMETERS_MAX_TRANSACTIONS 1
+#define SI5351_BENCH_OUTPUT_SET_PARAMETERS_MAX_BYTES_WRITTEN 2
+#define SI5351_BENCH_OUTPUT_SET_PARAMETERS_MAX_BYTES_READ   0
+
+#endif // SI5351_BENCH_THRESHOLDS_H_
@@ -0,0 +1,793 @@
+/*
+ * Copyright (c) 2025 Jonatan Gezelius
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Driver behaviour against the emulated register file and status timing
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/clock_control.h>
+#include <zephyr/drivers/clock_control/si5351.h>
+#include <zephyr/drivers/clock_control/si5351_emul.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/kernel.h>
+#include <zephyr/pm/device.h>
+#include <zephyr/pm/device_runtime.h>
+#include <zephyr/ztest.h>
+
+#if defined(CONFIG_CLOCK_CONTROL_SI5351_STATS) || defined(CONFIG_CLOCK_CONTROL_SI5351_SHELL)
+#include <string.h>
+#endif
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_STATS
+#include <zephyr/stats/stats.h>
+#endif
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_SHELL
+#include <stdarg.h>
+#include <stdio.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/shell/shell_dummy.h>
+#endif
+
+// Driver rounds the whole chain to nearest, the emulator rounds or truncates per divider stage
+#define SI5351_TEST_ROUNDING_MHZ 1
+// CLK0 to CLK5 multisynth blocks
+#define SI5351_TEST_MULTISYNTH_ADR 0x2a
+#define SI5351_TEST_MULTISYNTH_REGS 48
+// Output enable and CLK0 control registers
+#define SI5351_TEST_OEB_ADR 0x03
+#define SI5351_TEST_CLK0_CTRL_ADR 0x10
+// OEB to the last register, the interrupt mask depends on int-gpios and is left out
+#define SI5351_TEST_INIT_REGS (0xbc - SI5351_TEST_OEB_ADR)
+
+static const struct device *const si5351_dev = DEVICE_DT_GET(DT_NODELABEL(si5351));
+static const struct emul *const si5351_emul = EMUL_DT_GET(DT_NODELABEL(si5351));
+static const struct device *const clk_devs[] = {
+    DEVICE_DT_GET(DT_NODELABEL(clk0)),
+    DEVICE_DT_GET(DT_NODELABEL(clk1)),
+    DEVICE_DT_GET(DT_NODELABEL(clk2)),
+};
+static const struct device *const clk6_dev = DEVICE_DT_GET(DT_NODELABEL(clk6));
+
+ZTEST(si5351_emul, test_status_after_init)
+{
+    si5351_status_t status;
+
+    zassert_ok(si5351_get_status(si5351_dev, &status));
+    zassert_false(status.sys_init, "SYS_INIT still set");
+    zassert_false(status.plla_loss_of_lock, "PLLA not locked");
+    zassert_false(status.pllb_loss_of_lock, "PLLB not locked");
+}
+
+ZTEST(si5351_emul, test_cached_plan_matches_device)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(clk_devs); i++)
+    {
+        uint64_t expected, actual;
+
+        zassert_ok(si5351_output_get_frequency(clk_devs[i], &expected));
+        zassert_ok(si5351_emul_get_output_frequency(si5351_emul, i, &actual));
+        zassert_within(actual, expected, SI5351_TEST_ROUNDING_MHZ, "clk%d: %" PRIu64 " != %" PRIu64 " mHz", (int)i, actual, expected);
+    }
+}
+
+ZTEST(si5351_emul, test_set_frequency)
+{
+    static const uint64_t frequencies[] = {
+        10000000000ULL, // 10 MHz
+        7040100000ULL,  // 7.0401 MHz
+        144000000000ULL // 144 MHz
+    };
+
+    for (size_t i = 0; i < ARRAY_SIZE(frequencies); i++)
+    {
+        uint64_t actual;
+
+        zassert_ok(si5351_output_set_frequency(clk_devs[2], frequencies[i]));
+        zassert_ok(si5351_emul_get_output_frequency(si5351_emul, 2, &actual));
+        zassert_within(actual, frequencies[i], SI5351_TEST_ROUNDING_MHZ, "%" PRIu64 " != %" PRIu64 " mHz", actual, frequencies[i]);
+    }
+}
+
+ZTEST(si5351_emul, test_pll_reset_waits_for_lock)
+{
+    si5351_status_t status;
+
+    si5351_emul_set_lock_time(si5351_emul, 5000);
+
+    int64_t start = k_uptime_get();
+    zassert_ok(si5351_reset_pll(si5351_dev, si5351_pll_mask_a));
+    zassert_true(k_uptime_get() - start >= 5, "returned before the PLL locked");
+
+    zassert_ok(si5351_get_status(si5351_dev, &status));
+    zassert_false(status.plla_loss_of_lock, "PLLA not locked");
+
+    si5351_emul_set_lock_time(si5351_emul, CONFIG_EMUL_SI5351_LOCK_TIME_US);
+}
+
+ZTEST(si5351_emul, test_coherent_quadrature)
+{
+    static const uint64_t frequency = 14200000000ULL; // 14.2 MHz
+    const si5351_output_phase_t outputs[] = {
+        {.output = clk_devs[0], .phase = 0},
+        {.output = clk_devs[1], .phase = 270},
+    };
+    si5351_output_parameters_t i_parameters, q_parameters;
+
+    zassert_ok(si5351_set_frequency_coherent(si5351_dev, frequency, outputs, ARRAY_SIZE(outputs)));
+
+    for (size_t i = 0; i < ARRAY_SIZE(outputs); i++)
+    {
+        uint64_t actual;
+
+        zassert_ok(si5351_emul_get_output_frequency(si5351_emul, i, &actual));
+        zassert_within(actual, frequency, SI5351_TEST_ROUNDING_MHZ, "clk%d: %" PRIu64 " mHz", (int)i, actual);
+    }
+
+    zassert_ok(si5351_output_get_parameters(clk_devs[0], si5351_parameter_source_device, &i_parameters));
+    zassert_ok(si5351_output_get_parameters(clk_devs[1], si5351_parameter_source_device, &q_parameters));
+
+    // Even integer ratio N puts 90 degrees at N quarter VCO periods, 270 adds the inverter
+    uint32_t ratio = (q_parameters.p1 + 512) / 128;
+    zassert_equal(q_parameters.p2, 0, "fractional multisynth");
+    zassert_equal(ratio % 2, 0, "odd multisynth ratio %u", ratio);
+    zassert_equal(i_parameters.phase_offset, 0);
+    zassert_false(i_parameters.invert);
+    zassert_equal(q_parameters.phase_offset, ratio);
+    zassert_true(q_parameters.invert);
+}
+
+ZTEST(si5351_emul, test_coherent_rejects_shared_pll)
+{
+    const si5351_output_phase_t outputs[] = {
+        {.output = clk_devs[0], .phase = 0},
+    };
+    si5351_output_parameters_t clk0_parameters, clk1_parameters, shared;
+
+    // Put clk1 powered up on the PLL of clk0, which then stays outside the coherent set
+    zassert_ok(si5351_output_get_parameters(clk_devs[0], si5351_parameter_source_cache, &clk0_parameters));
+    zassert_ok(si5351_output_get_parameters(clk_devs[1], si5351_parameter_source_cache, &clk1_parameters));
+    shared = clk1_parameters;
+    shared.powered_up = si5351_output_powered_up;
+    shared.clock_source = si5351_output_clk_source_multisynth;
+    shared.multisynth_source = clk0_parameters.multisynth_source;
+    zassert_ok(si5351_output_set_parameters(clk_devs[1], &shared));
+
+    zassert_equal(si5351_set_frequency_coherent(si5351_dev, 14200000000ULL, outputs, ARRAY_SIZE(outputs)), -EBUSY);
+
+    zassert_ok(si5351_output_set_parameters(clk_devs[1], &clk1_parameters));
+}
+
+ZTEST(si5351_emul, test_group_defers_to_commit)
+{
+    static const struct device *const members[] = {si5351_dev};
+    const si5351_group_t group = {.devices = members, .num_devices = ARRAY_SIZE(members)};
+    static const uint64_t frequency = 21000000000ULL; // 21 MHz
+    si5351_emul_stats_t stats;
+    uint64_t actual;
+
+    zassert_ok(si5351_group_begin(&group));
+    si5351_emul_reset_stats(si5351_emul);
+    zassert_ok(si5351_output_set_frequency(clk_devs[2], frequency));
+    si5351_emul_get_stats(si5351_emul, &stats);
+    zassert_equal(stats.transactions, 0, "written before commit");
+    zassert_ok(si5351_group_commit(&group));
+
+    zassert_ok(si5351_emul_get_output_frequency(si5351_emul, 2, &actual));
+    zassert_within(actual, frequency, SI5351_TEST_ROUNDING_MHZ, "%" PRIu64 " mHz", actual);
+}
+
+ZTEST(si5351_emul, test_hop_table)
+{
+    si5351_hop_entry_t entries[4];
+    uint64_t frequencies[ARRAY_SIZE(entries)];
+    si5351_emul_stats_t stats;
+    si5351_parameters_t saved;
+    uint64_t base, expected, actual;
+
+    zassert_ok(si5351_get_parameters(si5351_dev, si5351_parameter_source_cache, &saved));
+    zassert_ok(si5351_output_get_frequency(clk_devs[2], &base));
+
+    // Channels 1 kHz apart from the current frequency on, CLK2 is alone on PLLB
+    for (size_t i = 0; i < ARRAY_SIZE(frequencies); i++)
+    {
+        frequencies[i] = base + i * 1000000ULL;
+    }
+    zassert_ok(si5351_output_encode_hop_table(clk_devs[2], frequencies, entries, ARRAY_SIZE(entries)));
+
+    for (size_t i = 0; i < ARRAY_SIZE(entries); i++)
+    {
+        zassert_equal(entries[i].parameters.p3, entries[0].parameters.p3, "entry %d", (int)i);
+
+        // No PLL reset and no read. The first hop also moves P3 to the shared denominator, after
+        // that its two leading bytes are never sent again and one burst of P1 and P2 remains.
+        si5351_emul_reset_stats(si5351_emul);
+        zassert_ok(si5351_output_hop(clk_devs[2], &entries[i]));
+        si5351_emul_get_stats(si5351_emul, &stats);
+        zassert_equal(stats.bytes_read, 0, "hop %d: %u bytes read", (int)i, stats.bytes_read);
+        if (i == 0)
+        {
+            zassert_true(stats.transactions <= 2, "hop %d: %u transactions", (int)i, stats.transactions);
+            zassert_true(stats.bytes_written <= stats.transactions + SI5351_HOP_ENTRY_REGISTERS,
+                         "hop %d: %u bytes written", (int)i, stats.bytes_written);
+        }
+        else
+        {
+            zassert_equal(stats.transactions, 1, "hop %d: %u transactions", (int)i, stats.transactions);
+            zassert_true(stats.bytes_written <= 1 + SI5351_HOP_ENTRY_REGISTERS - 2, "hop %d: %u bytes written", (int)i,
+                         stats.bytes_written);
+        }
+
+        zassert_ok(si5351_output_get_frequency(clk_devs[2], &expected));
+        zassert_ok(si5351_emul_get_output_frequency(si5351_emul, 2, &actual));
+        zassert_within(actual, expected, SI5351_TEST_ROUNDING_MHZ, "hop %d: %" PRIu64 " != %" PRIu64 " mHz", (int)i, actual,
+                       expected);
+        zassert_within(actual, frequencies[i], frequencies[i] / 1000000, "hop %d: %" PRIu64 " mHz", (int)i, actual);
+    }
+
+    // Hopping to the channel already set finds nothing to write
+    si5351_emul_reset_stats(si5351_emul);
+    zassert_ok(si5351_output_hop(clk_devs[2], &entries[ARRAY_SIZE(entries) - 1]));
+    si5351_emul_get_stats(si5351_emul, &stats);
+    zassert_equal(stats.transactions, 0, "%u transactions", stats.transactions);
+
+    zassert_ok(si5351_tune_pll(si5351_dev, si5351_pll_mask_b, &saved.pllb));
+}
+
+ZTEST(si5351_emul, test_fractional_multisynth)
+{
+    si5351_output_parameters_t saved, parameters;
+    uint64_t expected, actual;
+
+    zassert_ok(si5351_output_get_parameters(clk_devs[1], si5351_parameter_source_cache, &saved));
+
+    // Ratio just below 64 with a denominator close to the maximum
+    const uint32_t p3 = 1045145;
+    parameters = saved;
+    parameters.integer_mode = si5351_output_integer_mode_disabled;
+    parameters.divide_by_four = false;
+    parameters.p1 = 128 * 63 + 127 - 512;
+    parameters.p2 = p3 - 128;
+    parameters.p3 = p3;
+    zassert_ok(si5351_output_set_parameters(clk_devs[1], &parameters));
+
+    zassert_ok(si5351_output_get_frequency(clk_devs[1], &expected));
+    zassert_ok(si5351_emul_get_output_frequency(si5351_emul, 1, &actual));
+    zassert_within(actual, expected, SI5351_TEST_ROUNDING_MHZ, "%" PRIu64 " != %" PRIu64 " mHz", actual, expected);
+
+    zassert_ok(si5351_output_set_parameters(clk_devs[1], &saved));
+}
+
+ZTEST(si5351_emul, test_integer_output)
+{
+    si5351_output_parameters_t parameters, readback;
+    uint64_t expected, actual;
+
+    zassert_ok(si5351_output_get_parameters(clk6_dev, si5351_parameter_source_cache, &parameters));
+
+    // Odd ratios are not available on CLK6 and CLK7
+    parameters.p1 = 128 * 101 - 512;
+    zassert_equal(si5351_output_set_parameters(clk6_dev, &parameters), -EINVAL);
+
+    parameters.p1 = 128 * 100 - 512;
+    parameters.r = si5351_output_r_4;
+    parameters.powered_up = si5351_output_powered_up;
+    parameters.output_enabled = si5351_output_output_enabled;
+    zassert_ok(si5351_output_set_parameters(clk6_dev, &parameters));
+
+    zassert_ok(si5351_output_get_parameters(clk6_dev, si5351_parameter_source_device, &readback));
+    zassert_equal(readback.p1, parameters.p1);
+    zassert_equal(readback.r, si5351_output_r_4);
+
+    zassert_ok(si5351_output_get_frequency(clk6_dev, &expected));
+    zassert_ok(si5351_emul_get_output_frequency(si5351_emul, 6, &actual));
+    zassert_within(actual, expected, SI5351_TEST_ROUNDING_MHZ, "%" PRIu64 " != %" PRIu64 " mHz", actual, expected);
+
+    // Powered down again so it does not pin PLLB for the other tests
+    parameters.powered_up = si5351_output_powered_down;
+    parameters.output_enabled = si5351_output_output_disabled;
+    zassert_ok(si5351_output_set_parameters(clk6_dev, &parameters));
+}
+
+ZTEST(si5351_emul, test_frequency_plan)
+{
+    // 25 and 10 MHz divide 800 MHz evenly, 12.288 MHz needs a VCO of its own
+    si5351_output_request_t requests[] = {
+        {clk_devs[0], 25000000000ULL},
+        {clk_devs[1], 12288000000ULL},
+        {clk_devs[2], 10000000000ULL},
+    };
+    si5351_frequency_plan_t plan;
+    uint64_t actual;
+
+    zassert_ok(si5351_plan_frequencies(si5351_dev, requests, ARRAY_SIZE(requests), &plan));
+    zassert_equal(plan.num_fractional, 0);
+    zassert_equal(plan.parameters[0].multisynth_source, plan.parameters[2].multisynth_source);
+    zassert_not_equal(plan.parameters[0].multisynth_source, plan.parameters[1].multisynth_source);
+
+    zassert_ok(si5351_apply_frequency_plan(si5351_dev, &plan));
+
+    for (size_t i = 0; i < ARRAY_SIZE(requests); i++)
+    {
+        zassert_ok(si5351_emul_get_output_frequency(si5351_emul, i, &actual));
+        zassert_within(actual, requests[i].frequency, SI5351_TEST_ROUNDING_MHZ, "clk%d: %" PRIu64 " mHz", i, actual);
+    }
+
+    // Planning the same frequencies again keeps both PLLs
+    zassert_ok(si5351_plan_frequencies(si5351_dev, requests, ARRAY_SIZE(requests), &plan));
+    zassert_equal(plan.pll_reset, 0);
+}
+
+ZTEST(si5351_emul, test_frequency_plan_integer_output)
+{
+    // 150 MHz on CLK6 needs a ratio of 6 from a 900 MHz VCO, divide by four is not available there
+    si5351_output_request_t requests[] = {
+        {clk_devs[0], 25000000000ULL},
+        {clk_devs[1], 12288000000ULL},
+        {clk_devs[2], 10000000000ULL},
+        {clk6_dev, 150000000000ULL},
+    };
+    si5351_frequency_plan_t plan;
+
+    zassert_ok(si5351_plan_frequencies(si5351_dev, requests, ARRAY_SIZE(requests), &plan));
+    zassert_false(plan.parameters[3].divide_by_four);
+    zassert_equal(plan.parameters[3].p1, 6 * 128 - 512);
+    zassert_equal(plan.parameters[3].p2, 0);
+}
+
+ZTEST(si5351_emul, test_xtal_correction)
+{
+    uint8_t multisynth[SI5351_TEST_MULTISYNTH_REGS], readback[SI5351_TEST_MULTISYNTH_REGS];
+    si5351_emul_stats_t stats;
+    uint64_t expected, actual;
+
+    zassert_ok(si5351_output_get_frequency(clk_devs[0], &expected));
+    for (int i = 0; i < SI5351_TEST_MULTISYNTH_REGS; i++)
+    {
+        zassert_ok(si5351_emul_get_reg(si5351_emul, SI5351_TEST_MULTISYNTH_ADR + i, &multisynth[i]));
+    }
+
+    // A crystal running 20 ppm fast moves the output by as much until it is calibrated
+    si5351_emul_set_xtal_error(si5351_emul, 20000);
+    zassert_ok(si5351_emul_get_output_frequency(si5351_emul, 0, &actual));
+    zassert_true(actual > expected + expected / 100000, "%" PRIu64 " mHz", actual);
+
+    si5351_emul_reset_stats(si5351_emul);
+    zassert_ok(si5351_set_xtal_correction(si5351_dev, 20000));
+    si5351_emul_get_stats(si5351_emul, &stats);
+
+    zassert_ok(si5351_emul_get_output_frequency(si5351_emul, 0, &actual));
+    zassert_within(actual, expected, SI5351_TEST_ROUNDING_MHZ, "%" PRIu64 " != %" PRIu64 " mHz", actual, expected);
+
+    // Only PLL bytes went out, no reset and no multisynth
+    for (int i = 0; i < SI5351_TEST_MULTISYNTH_REGS; i++)
+    {
+        zassert_ok(si5351_emul_get_reg(si5351_emul, SI5351_TEST_MULTISYNTH_ADR + i, &readback[i]));
+    }
+    zassert_mem_equal(readback, multisynth, sizeof(multisynth));
+    zassert_true(stats.bytes_written <= 2 * (1 + SI5351_HOP_ENTRY_REGISTERS), "%u bytes", stats.bytes_written);
+
+    si5351_emul_set_xtal_error(si5351_emul, 0);
+    zassert_ok(si5351_set_xtal_correction(si5351_dev, 0));
+}
+
+ZTEST(si5351_emul, test_discipline)
+{
+    si5351_output_parameters_t output;
+    si5351_parameters_t saved;
+    uint64_t expected;
+    int32_t error_ppb;
+
+    zassert_ok(si5351_output_get_frequency(clk_devs[0], &expected));
+    zassert_ok(si5351_output_get_parameters(clk_devs[0], si5351_parameter_source_cache, &output));
+    zassert_ok(si5351_get_parameters(si5351_dev, si5351_parameter_source_cache, &saved));
+    si5351_pll_mask_t pll_mask =
+        output.multisynth_source == si5351_output_multisynth_source_pllb ? si5351_pll_mask_b : si5351_pll_mask_a;
+
+    // Uncalibrated crystal 15 ppm slow, steered back against the simulated reference. Slow so that
+    // the correction raises the VCO, the integer plans leave it on the 600 MHz floor.
+    si5351_emul_discipline_source_t source = {si5351_emul, 0, expected};
+    si5351_discipline_t discipline = {
+        .output = clk_devs[0],
+        .measure = si5351_emul_discipline_measure,
+        .user_data = &source,
+        .interval_ms = 100,
+        .kp = 32768,
+        .ki = 16384,
+        .lock_threshold_ppb = 2,
+        .lock_count = 3,
+    };
+    si5351_emul_set_xtal_error(si5351_emul, -15000);
+
+    zassert_ok(si5351_discipline_start(&discipline));
+    zassert_equal(si5351_discipline_start(&discipline), -EBUSY);
+    for (int i = 0; i < 100 && !discipline.locked; i++)
+    {
+        k_sleep(K_MSEC(discipline.interval_ms));
+    }
+    zassert_ok(si5351_discipline_stop(&discipline));
+    zassert_equal(si5351_discipline_stop(&discipline), -EALREADY);
+
+    zassert_true(discipline.locked, "residual %d ppb after %u samples", discipline.residual_ppb, discipline.samples);
+    zassert_within(discipline.correction_ppb, 15000, 100, "%d ppb", discipline.correction_ppb);
+    zassert_ok(si5351_emul_discipline_measure(clk_devs[0], &error_ppb, &source));
+    zassert_within(error_ppb, 0, 2, "%d ppb", error_ppb);
+
+    si5351_emul_set_xtal_error(si5351_emul, 0);
+    zassert_ok(si5351_tune_pll(si5351_dev, pll_mask, pll_mask == si5351_pll_mask_b ? &saved.pllb : &saved.plla));
+}
+
+static struct
+{
+    si5351_event_callback_t callback;
+    uint8_t events;
+    uint32_t calls;
+    si5351_status_t status;
+} si5351_test_event;
+
+static void si5351_test_event_handler(const struct device *dev, si5351_event_callback_t *callback, uint8_t events,
+                                      si5351_status_t const *status)
+{
+    si5351_test_event.events |= events;
+    si5351_test_event.calls++;
+    si5351_test_event.status = *status;
+}
+
+ZTEST(si5351_emul, test_interrupt_events)
+{
+    si5351_emul_stats_t stats;
+    si5351_status_t status;
+
+    si5351_test_event.callback.handler = si5351_test_event_handler;
+    si5351_test_event.callback.events = si5351_event_xtal_loss_of_signal | si5351_event_plla_loss_of_lock |
+                                        si5351_event_pllb_loss_of_lock;
+    zassert_ok(si5351_add_event_callback(si5351_dev, &si5351_test_event.callback));
+    k_sleep(K_MSEC(1));
+
+    // Nothing pending, the status comes from the cache
+    si5351_emul_reset_stats(si5351_emul);
+    zassert_ok(si5351_get_status(si5351_dev, &status));
+    si5351_emul_get_stats(si5351_emul, &stats);
+    zassert_equal(stats.transactions, 0, "%u transactions", stats.transactions);
+
+    // A PLL reset of the driver is not an event
+    zassert_ok(si5351_reset_pll(si5351_dev, si5351_pll_mask_a));
+    k_sleep(K_MSEC(1));
+    zassert_equal(si5351_test_event.calls, 0);
+
+    // Loss of the crystal fires once, the source stays masked while the condition persists
+    si5351_emul_set_loss_of_signal(si5351_emul, true, false);
+    k_sleep(K_MSEC(1));
+    zassert_equal(si5351_test_event.calls, 1);
+    zassert_equal(si5351_test_event.events, si5351_event_xtal_loss_of_signal);
+    zassert_true(si5351_test_event.status.xtal_loss_of_signal);
+    zassert_ok(si5351_get_status(si5351_dev, &status));
+    zassert_true(status.xtal_loss_of_signal);
+
+    // Recovery is seen by the recheck, after which the status is cached again
+    si5351_emul_set_loss_of_signal(si5351_emul, false, false);
+    k_sleep(K_MSEC(CONFIG_CLOCK_CONTROL_SI5351_INTERRUPT_RECHECK_MS + 1));
+    zassert_equal(si5351_test_event.calls, 1);
+
+    si5351_emul_reset_stats(si5351_emul);
+    zassert_ok(si5351_get_status(si5351_dev, &status));
+    si5351_emul_get_stats(si5351_emul, &stats);
+    zassert_false(status.xtal_loss_of_signal);
+    zassert_equal(stats.transactions, 0, "%u transactions", stats.transactions);
+
+    zassert_ok(si5351_remove_event_callback(si5351_dev, &si5351_test_event.callback));
+}
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_ASYNC
+static int si5351_test_wait_signal(struct k_poll_signal *signal)
+{
+    struct k_poll_event event = K_POLL_EVENT_INITIALIZER(K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, signal);
+    unsigned int signaled;
+    int result;
+
+    zassert_ok(k_poll(&event, 1, K_MSEC(100)), "no completion");
+    k_poll_signal_check(signal, &signaled, &result);
+    zassert_true(signaled);
+    k_poll_signal_reset(signal);
+
+    return result;
+}
+
+static void si5351_test_on_callback(const struct device *dev, clock_control_subsys_t subsys, void *user_data)
+{
+    k_poll_signal_raise(user_data, 0);
+}
+
+ZTEST(si5351_emul, test_async)
+{
+    si5351_output_parameters_t output, saved_output, readback;
+    si5351_parameters_t saved;
+    si5351_pll_parameters_t pll;
+    struct k_poll_signal signal;
+    uint64_t expected, actual;
+
+    k_poll_signal_init(&signal);
+
+    // The output change is written from the driver work queue and completed through the signal
+    zassert_ok(si5351_output_get_parameters(clk_devs[1], si5351_parameter_source_cache, &saved_output));
+    output = saved_output;
+    output.p1 = 128 * 64 - 512;
+    zassert_ok(si5351_output_set_parameters_async(clk_devs[1], &output, &signal));
+    zassert_ok(si5351_test_wait_signal(&signal));
+    zassert_ok(si5351_output_get_parameters(clk_devs[1], si5351_parameter_source_device, &readback));
+    zassert_equal(readback.p1, output.p1);
+
+    // PLLB moves to 700 MHz, CLK2 follows
+    zassert_ok(si5351_get_parameters(si5351_dev, si5351_parameter_source_cache, &saved));
+    pll = saved.pllb;
+    pll.p1 = 128 * 28 - 512;
+    pll.p2 = 0;
+    zassert_ok(si5351_tune_pll_async(si5351_dev, si5351_pll_mask_b, &pll, &signal));
+    zassert_ok(si5351_test_wait_signal(&signal));
+    zassert_ok(si5351_output_get_frequency(clk_devs[2], &expected));
+    zassert_ok(si5351_emul_get_output_frequency(si5351_emul, 2, &actual));
+    zassert_within(actual, expected, SI5351_TEST_ROUNDING_MHZ, "%" PRIu64 " != %" PRIu64 " mHz", actual, expected);
+
+    zassert_ok(si5351_tune_pll_async(si5351_dev, si5351_pll_mask_b, &saved.pllb, &signal));
+    zassert_ok(si5351_test_wait_signal(&signal));
+    zassert_ok(si5351_output_set_parameters_async(clk_devs[1], &saved_output, &signal));
+    zassert_ok(si5351_test_wait_signal(&signal));
+
+    // The clock_control callback only fires once the output is enabled on the device
+    zassert_ok(clock_control_off(clk_devs[1], NULL));
+    zassert_ok(clock_control_async_on(clk_devs[1], NULL, si5351_test_on_callback, &signal));
+    zassert_ok(si5351_test_wait_signal(&signal));
+    zassert_ok(si5351_output_get_parameters(clk_devs[1], si5351_parameter_source_device, &readback));
+    zassert_equal(readback.output_enabled, si5351_output_output_enabled);
+    zassert_equal(clock_control_async_on(clk_devs[1], NULL, si5351_test_on_callback, &signal), -EALREADY);
+}
+#endif
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_STATS
+typedef struct
+{
+    uint32_t transactions;
+    uint32_t bytes_written;
+    uint32_t bytes_read;
+    uint32_t pll_resets;
+} si5351_test_counters_t;
+
+static int si5351_test_stats_walk(struct stats_hdr *hdr, void *arg, const char *name, uint16_t off)
+{
+    si5351_test_counters_t *counters = arg;
+    uint32_t value = *(uint32_t *)((uint8_t *)hdr + off);
+
+    if (strcmp(name, "transactions") == 0)
+    {
+        counters->transactions = value;
+    }
+    else if (strcmp(name, "bytes_written") == 0)
+    {
+        counters->bytes_written = value;
+    }
+    else if (strcmp(name, "bytes_read") == 0)
+    {
+        counters->bytes_read = value;
+    }
+    else if (strcmp(name, "pll_resets") == 0)
+    {
+        counters->pll_resets = value;
+    }
+
+    return 0;
+}
+
+ZTEST(si5351_emul, test_stats)
+{
+    struct stats_hdr *hdr = stats_group_find(si5351_dev->name);
+    si5351_test_counters_t counters = {0};
+    si5351_emul_stats_t stats;
+
+    zassert_not_null(hdr, "no stats group %s", si5351_dev->name);
+
+    // The driver accounts for exactly the traffic the device sees
+    zassert_ok(si5351_stats_reset(si5351_dev));
+    si5351_emul_reset_stats(si5351_emul);
+    zassert_ok(si5351_output_set_frequency(clk_devs[2], 12000000000ULL));
+    zassert_ok(si5351_reset_pll(si5351_dev, si5351_pll_mask_b));
+    si5351_emul_get_stats(si5351_emul, &stats);
+
+    zassert_ok(stats_walk(hdr, si5351_test_stats_walk, &counters));
+    zassert_equal(counters.transactions, stats.transactions, "%u != %u", counters.transactions, stats.transactions);
+    zassert_equal(counters.bytes_written, stats.bytes_written, "%u != %u", counters.bytes_written, stats.bytes_written);
+    zassert_equal(counters.bytes_read, stats.bytes_read, "%u != %u", counters.bytes_read, stats.bytes_read);
+    zassert_true(counters.pll_resets >= 1, "%u PLL resets", counters.pll_resets);
+}
+#endif
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_SHELL
+// CLK0 phase offset, safe to poke while the output is not part of a coherent set
+#define SI5351_TEST_CLK0_PHASE_ADR 0xa5
+
+static int si5351_test_shell(const struct shell *sh, const char *fmt, ...)
+{
+    char command[64];
+    va_list args;
+
+    va_start(args, fmt);
+    vsnprintf(command, sizeof(command), fmt, args);
+    va_end(args);
+
+    shell_backend_dummy_clear_output(sh);
+    return shell_execute_cmd(sh, command);
+}
+
+ZTEST(si5351_emul, test_shell)
+{
+    const struct shell *sh = shell_backend_dummy_get_ptr();
+    const char *output;
+    uint64_t actual;
+    uint8_t saved, value;
+    size_t size;
+
+    WAIT_FOR(shell_ready(sh), 20000, k_msleep(1));
+    zassert_true(shell_ready(sh), "dummy shell backend not ready");
+
+    // Frequencies are given and printed in Hz with three decimals
+    zassert_ok(si5351_test_shell(sh, "si5351 freq %s 2 12000000.5", si5351_dev->name));
+    output = shell_backend_dummy_get_output(sh, &size);
+    zassert_not_null(strstr(output, "12000000.500 Hz"), "%s", output);
+    zassert_ok(si5351_emul_get_output_frequency(si5351_emul, 2, &actual));
+    zassert_within(actual, 12000000500ULL, SI5351_TEST_ROUNDING_MHZ, "%" PRIu64 " mHz", actual);
+
+    // Raw register access goes straight to the device
+    zassert_ok(si5351_emul_get_reg(si5351_emul, SI5351_TEST_CLK0_PHASE_ADR, &saved));
+    zassert_ok(si5351_test_shell(sh, "si5351 poke %s 0x%02x 0x2a", si5351_dev->name, SI5351_TEST_CLK0_PHASE_ADR));
+    zassert_ok(si5351_emul_get_reg(si5351_emul, SI5351_TEST_CLK0_PHASE_ADR, &value));
+    zassert_equal(value, 0x2a);
+    zassert_ok(si5351_test_shell(sh, "si5351 dump %s 0x%02x", si5351_dev->name, SI5351_TEST_CLK0_PHASE_ADR));
+    output = shell_backend_dummy_get_output(sh, &size);
+    zassert_not_null(strstr(output, "2a"), "%s", output);
+    zassert_ok(si5351_test_shell(sh, "si5351 poke %s 0x%02x 0x%02x", si5351_dev->name, SI5351_TEST_CLK0_PHASE_ADR, saved));
+
+    zassert_not_equal(si5351_test_shell(sh, "si5351 status nosuchdevice"), 0);
+}
+#endif
+
+#ifdef CONFIG_CLOCK_CONTROL_SI5351_SEQUENCER
+static K_SEM_DEFINE(si5351_test_sequence_done, 0, 1);
+static int si5351_test_sequence_result;
+
+static void si5351_test_sequence_callback(const struct device *dev, int result, void *user_data)
+{
+    si5351_test_sequence_result = result;
+    k_sem_give(&si5351_test_sequence_done);
+}
+
+ZTEST(si5351_emul, test_sequencer)
+{
+    si5351_parameters_t saved;
+    uint64_t frequency, actual;
+
+    zassert_ok(si5351_get_parameters(si5351_dev, si5351_parameter_source_cache, &saved));
+    zassert_ok(si5351_output_get_frequency(clk_devs[2], &frequency));
+
+    // Two steps 10 and 20 ppm up, the output is left on the last one
+    si5351_sequence_step_t steps[] = {
+        {.frequency = frequency + frequency / 100000, .dwell_us = 1000},
+        {.frequency = frequency + frequency / 50000, .dwell_us = 1000},
+    };
+    si5351_sequencer_t sequencer = {
+        .output = clk_devs[2],
+        .steps = steps,
+        .num_steps = ARRAY_SIZE(steps),
+        .callback = si5351_test_sequence_callback,
+    };
+
+    k_sem_reset(&si5351_test_sequence_done);
+    zassert_ok(si5351_sequencer_start(&sequencer));
+    zassert_ok(k_sem_take(&si5351_test_sequence_done, K_MSEC(100)), "sequence did not complete");
+    zassert_ok(si5351_test_sequence_result);
+    zassert_equal(sequencer.iterations, 1, "%u passes", sequencer.iterations);
+
+    zassert_ok(si5351_emul_get_output_frequency(si5351_emul, 2, &actual));
+    zassert_within(actual, steps[1].frequency, steps[1].frequency / 1000000, "%" PRIu64 " mHz", actual);
+
+    zassert_ok(si5351_tune_pll(si5351_dev, si5351_pll_mask_b, &saved.pllb));
+}
+#endif
+
+// Control and configuration registers, everything after the status and sticky bytes
+#define SI5351_TEST_CONFIG_ADR 0x02
+#define SI5351_TEST_CONFIG_REGS (0xbc - SI5351_TEST_CONFIG_ADR)
+
+static void si5351_test_read_config(uint8_t *regs)
+{
+    for (int i = 0; i < SI5351_TEST_CONFIG_REGS; i++)
+    {
+        zassert_ok(si5351_emul_get_reg(si5351_emul, SI5351_TEST_CONFIG_ADR + i, &regs[i]));
+    }
+}
+
+ZTEST(si5351_emul, test_runtime_pm)
+{
+    uint8_t expected[SI5351_TEST_CONFIG_REGS], restored[SI5351_TEST_CONFIG_REGS];
+    si5351_emul_stats_t stats;
+    enum pm_device_state state;
+    uint8_t clk_ctrl, oeb;
+
+    // Enabling runtime PM suspends the unused output, its multisynth and driver are powered down
+    zassert_ok(pm_device_runtime_enable(si5351_dev));
+    zassert_ok(pm_device_runtime_enable(clk_devs[0]));
+    zassert_ok(si5351_emul_get_reg(si5351_emul, SI5351_TEST_CLK0_CTRL_ADR, &clk_ctrl));
+    zassert_ok(si5351_emul_get_reg(si5351_emul, SI5351_TEST_OEB_ADR, &oeb));
+    zassert_true(clk_ctrl & BIT(7));
+    zassert_true(oeb & BIT(0));
+
+    // Two consumers, the output stays up until the last one releases it
+    zassert_ok(clock_control_on(clk_devs[0], NULL));
+    zassert_ok(clock_control_on(clk_devs[0], NULL));
+    si5351_test_read_config(expected);
+    zassert_ok(clock_control_off(clk_devs[0], NULL));
+    zassert_ok(si5351_emul_get_reg(si5351_emul, SI5351_TEST_CLK0_CTRL_ADR, &clk_ctrl));
+    zassert_false(clk_ctrl & BIT(7));
+    zassert_ok(clock_control_off(clk_devs[0], NULL));
+    zassert_ok(si5351_emul_get_reg(si5351_emul, SI5351_TEST_CLK0_CTRL_ADR, &clk_ctrl));
+    zassert_true(clk_ctrl & BIT(7));
+
+    // With no output in use the chip is suspended, cut its power
+    zassert_ok(pm_device_state_get(si5351_dev, &state));
+    zassert_equal(state, PM_DEVICE_STATE_SUSPENDED);
+    zassert_ok(pm_device_action_run(si5351_dev, PM_DEVICE_ACTION_TURN_OFF));
+    si5351_emul_power_up(si5351_emul);
+    zassert_ok(pm_device_action_run(si5351_dev, PM_DEVICE_ACTION_TURN_ON));
+
+    // Resume rewrites the shadow in bursts, not one addressed write per register
+    si5351_emul_reset_stats(si5351_emul);
+    zassert_ok(clock_control_on(clk_devs[0], NULL));
+    si5351_emul_get_stats(si5351_emul, &stats);
+    si5351_test_read_config(restored);
+    zassert_mem_equal(restored, expected, sizeof(expected));
+    zassert_true(stats.bytes_written <= SI5351_TEST_CONFIG_REGS + 32, "%u bytes written", stats.bytes_written);
+
+    zassert_ok(clock_control_off(clk_devs[0], NULL));
+    zassert_ok(pm_device_runtime_disable(clk_devs[0]));
+    zassert_ok(pm_device_runtime_disable(si5351_dev));
+}
+
+// Register file from OEB to the fanout register after init, as the runtime encoding leaves it for
+// the devicetree of this test. The init image variant has to write exactly the same bytes.
+static const uint8_t si5351_test_init_regs[SI5351_TEST_INIT_REGS] = {
+    0xf8, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4f, 0x4f, 0x6f,
+    0x80, 0x80, 0x80, 0xef, 0x80, 0x00, 0x00, 0x00, 0x01, 0x00, 0x0d, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x0d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x1c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x17, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x64, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xd2, 0x00, 0x00, 0x00, 0x00,
+};
+static uint8_t init_regs[SI5351_TEST_INIT_REGS];
+
+ZTEST(si5351_emul, test_init_register_file)
+{
+    for (int i = 0; i < SI5351_TEST_INIT_REGS; i++)
+    {
+        zassert_equal(init_regs[i], si5351_test_init_regs[i], "0x%02x: 0x%02x != 0x%02x", SI5351_TEST_OEB_ADR + i,
+                      init_regs[i], si5351_test_init_regs[i]);
+    }
+}
+
+static void *si5351_emul_setup(void)
+{
+    zassert_true(device_is_ready(si5351_dev), "si5351 not ready");
+
+    // Captured before any test changes the configuration
+    for (int i = 0; i < SI5351_TEST_INIT_REGS; i++)
+    {
+        zassert_ok(si5351_emul_get_reg(si5351_emul, SI5351_TEST_OEB_ADR + i, &init_regs[i]));
+    }
+
+    return NULL;
+}
+
+ZTEST_SUITE(si5351_emul, NULL, si5351_emul_setup, NULL, NULL, NULL);
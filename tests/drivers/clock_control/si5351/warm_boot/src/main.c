@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2025 Jonatan Gezelius
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Initialization after an MCU-only reset, against emulated chips that kept or lost their configuration
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/clock_control/si5351.h>
+#include <zephyr/drivers/clock_control/si5351_emul.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+// Control and configuration registers, everything after the status and sticky bytes
+#define SI5351_TEST_CONFIG_ADR 0x02
+#define SI5351_TEST_CONFIG_REGS (0xbc - SI5351_TEST_CONFIG_ADR)
+
+static const struct emul *const ref_emul = EMUL_DT_GET(DT_NODELABEL(si5351_ref));
+
+static const struct device *const retained_dev = DEVICE_DT_GET(DT_NODELABEL(si5351_retained));
+static const struct device *const retained_clk = DEVICE_DT_GET(DT_NODELABEL(clk_retained));
+static const struct emul *const retained_emul = EMUL_DT_GET(DT_NODELABEL(si5351_retained));
+
+static const struct device *const cycled_dev = DEVICE_DT_GET(DT_NODELABEL(si5351_cycled));
+static const struct device *const cycled_clk = DEVICE_DT_GET(DT_NODELABEL(clk_cycled));
+static const struct emul *const cycled_emul = EMUL_DT_GET(DT_NODELABEL(si5351_cycled));
+
+static void si5351_test_read_config(const struct emul *target, uint8_t *regs)
+{
+    for (int i = 0; i < SI5351_TEST_CONFIG_REGS; i++)
+    {
+        zassert_ok(si5351_emul_get_reg(target, SI5351_TEST_CONFIG_ADR + i, &regs[i]));
+    }
+}
+
+static void si5351_test_init(const struct device *dev, const struct device *clk)
+{
+    zassert_ok(device_init(dev));
+    zassert_ok(device_init(clk));
+    zassert_true(device_is_ready(clk), "output not ready");
+}
+
+ZTEST(si5351_warm_boot, test_retained_not_rewritten)
+{
+    uint8_t expected[SI5351_TEST_CONFIG_REGS], actual[SI5351_TEST_CONFIG_REGS];
+    si5351_emul_stats_t stats;
+
+    // The chip still runs the configuration of the reference from before the MCU reset
+    si5351_test_read_config(ref_emul, expected);
+    for (int i = 0; i < SI5351_TEST_CONFIG_REGS; i++)
+    {
+        zassert_ok(si5351_emul_set_reg(retained_emul, SI5351_TEST_CONFIG_ADR + i, expected[i]));
+    }
+    k_sleep(K_MSEC(CONFIG_EMUL_SI5351_SYS_INIT_TIME_MS + 1));
+
+    // Every write carries only a register address ahead of a read
+    si5351_emul_reset_stats(retained_emul);
+    si5351_test_init(retained_dev, retained_clk);
+    si5351_emul_get_stats(retained_emul, &stats);
+    zassert_equal(stats.bytes_written, stats.transactions, "%u bytes written in %u transactions", stats.bytes_written,
+                  stats.transactions);
+
+    si5351_test_read_config(retained_emul, actual);
+    zassert_mem_equal(actual, expected, sizeof(expected));
+}
+
+ZTEST(si5351_warm_boot, test_power_cycled_rewritten)
+{
+    uint8_t expected[SI5351_TEST_CONFIG_REGS], actual[SI5351_TEST_CONFIG_REGS];
+    si5351_emul_stats_t stats;
+
+    // Lost its configuration together with the MCU, SYS_INIT is set again
+    si5351_emul_power_up(cycled_emul);
+
+    si5351_emul_reset_stats(cycled_emul);
+    si5351_test_init(cycled_dev, cycled_clk);
+    si5351_emul_get_stats(cycled_emul, &stats);
+    zassert_true(stats.bytes_written > stats.transactions, "configuration not written");
+
+    si5351_test_read_config(ref_emul, expected);
+    si5351_test_read_config(cycled_emul, actual);
+    zassert_mem_equal(actual, expected, sizeof(expected));
+}
+
+ZTEST_SUITE(si5351_warm_boot, NULL, NULL, NULL, NULL, NULL);